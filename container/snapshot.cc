@@ -0,0 +1,378 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/preprocessor/os.h>
+#include <pycpp/stl/container/snapshot.h>
+#include <pycpp/stl/system_error.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#if defined(PYCPP_WINDOWS)
+#   include <io.h>
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+// HELPERS
+// -------
+
+[[noreturn]] static
+void
+throw_errno(
+    const char* what
+)
+{
+    throw system_error(errno, generic_category(), what);
+}
+
+#if defined(PYCPP_WINDOWS)          // WINDOWS
+
+[[noreturn]] static
+void
+throw_last_error(
+    const char* what
+)
+{
+    throw system_error(static_cast<int>(GetLastError()), system_category(), what);
+}
+
+static
+const void*
+map_file(
+    const char* path,
+    size_t& size
+)
+{
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw_last_error("snapshot: unable to open file");
+    }
+
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(file, &length)) {
+        CloseHandle(file);
+        throw_last_error("snapshot: unable to stat file");
+    }
+    size = static_cast<size_t>(length.QuadPart);
+    if (size < sizeof(snapshot_header)) {
+        CloseHandle(file);
+        throw runtime_error("snapshot: file too small for header.");
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        throw_last_error("snapshot: unable to map file");
+    }
+
+    // the view holds a reference to the mapping object
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr) {
+        throw_last_error("snapshot: unable to map file");
+    }
+
+    return data;
+}
+
+static
+void
+unmap_file(
+    const void* data,
+    size_t
+)
+noexcept
+{
+    UnmapViewOfFile(data);
+}
+
+static
+FILE*
+open_temporary(
+    const char* path,
+    std::string& temp
+)
+{
+    // unique within the directory, for concurrent writers
+    temp = path;
+    temp += ".tmp.";
+    temp += std::to_string(GetCurrentProcessId());
+    temp += '.';
+    temp += std::to_string(GetCurrentThreadId());
+    FILE* file = std::fopen(temp.c_str(), "wb");
+    if (file == nullptr) {
+        throw_errno("snapshot: unable to open file");
+    }
+    return file;
+}
+
+static
+bool
+sync_file(
+    FILE* file
+)
+noexcept
+{
+    return _commit(_fileno(file)) == 0;
+}
+
+static
+void
+replace_file(
+    const char* temp,
+    const char* path
+)
+{
+    if (!MoveFileExA(temp, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        DWORD code = GetLastError();
+        DeleteFileA(temp);
+        throw system_error(static_cast<int>(code), system_category(), "snapshot: unable to replace file");
+    }
+}
+
+#else                               // POSIX
+
+static
+const void*
+map_file(
+    const char* path,
+    size_t& size
+)
+{
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw_errno("snapshot: unable to open file");
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) == -1) {
+        int code = errno;
+        ::close(fd);
+        throw system_error(code, generic_category(), "snapshot: unable to stat file");
+    }
+    size = static_cast<size_t>(st.st_size);
+    if (size < sizeof(snapshot_header)) {
+        ::close(fd);
+        throw runtime_error("snapshot: file too small for header.");
+    }
+
+    // the mapping holds a reference to the file, close the descriptor
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    int code = errno;
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw system_error(code, generic_category(), "snapshot: unable to map file");
+    }
+
+    return data;
+}
+
+static
+void
+unmap_file(
+    const void* data,
+    size_t size
+)
+noexcept
+{
+    ::munmap(const_cast<void*>(data), size);
+}
+
+static
+FILE*
+open_temporary(
+    const char* path,
+    std::string& temp
+)
+{
+    temp = path;
+    temp += ".tmp.XXXXXX";
+    int fd = ::mkstemp(&temp[0]);
+    if (fd == -1) {
+        throw_errno("snapshot: unable to open file");
+    }
+    FILE* file = ::fdopen(fd, "wb");
+    if (file == nullptr) {
+        int code = errno;
+        ::close(fd);
+        ::unlink(temp.c_str());
+        throw system_error(code, generic_category(), "snapshot: unable to open file");
+    }
+    return file;
+}
+
+static
+bool
+sync_file(
+    FILE* file
+)
+noexcept
+{
+    return ::fsync(::fileno(file)) == 0;
+}
+
+static
+void
+replace_file(
+    const char* temp,
+    const char* path
+)
+{
+    if (::rename(temp, path) == -1) {
+        int code = errno;
+        ::unlink(temp);
+        throw system_error(code, generic_category(), "snapshot: unable to replace file");
+    }
+
+    // persist the rename, by syncing the parent directory
+    std::string directory = path;
+    size_t slash = directory.rfind('/');
+    directory = slash == std::string::npos ? "." : directory.substr(0, slash == 0 ? 1 : slash);
+    int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd != -1) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+#endif                              // WINDOWS
+
+// OBJECTS
+// -------
+
+snapshot_mapping::snapshot_mapping(
+    const char* path
+)
+{
+    data_ = map_file(path, size_);
+}
+
+
+snapshot_mapping::snapshot_mapping(
+    snapshot_mapping&& rhs
+)
+noexcept:
+    data_(rhs.data_),
+    size_(rhs.size_)
+{
+    rhs.data_ = nullptr;
+    rhs.size_ = 0;
+}
+
+
+snapshot_mapping&
+snapshot_mapping::operator=(
+    snapshot_mapping&& rhs
+)
+noexcept
+{
+    PYSTD::swap(data_, rhs.data_);
+    PYSTD::swap(size_, rhs.size_);
+    return *this;
+}
+
+
+snapshot_mapping::~snapshot_mapping()
+{
+    if (data_) {
+        unmap_file(data_, size_);
+    }
+}
+
+
+const snapshot_header&
+snapshot_mapping::validate(
+    size_t value_size,
+    size_t value_alignment
+)
+const
+{
+    auto& header = *static_cast<const snapshot_header*>(data_);
+    if (std::memcmp(header.magic, "PYSNAP", 6) != 0) {
+        throw runtime_error("snapshot: invalid file signature.");
+    } else if (header.version != SNAPSHOT_VERSION) {
+        throw runtime_error("snapshot: unsupported version.");
+    } else if (header.byte_order != static_cast<uint32_t>(endian::native)) {
+        throw runtime_error("snapshot: byte order mismatch.");
+    } else if (header.value_size != value_size || header.value_alignment != value_alignment) {
+        throw runtime_error("snapshot: value layout mismatch.");
+    } else if (header.offset < sizeof(snapshot_header) || header.offset % value_alignment != 0) {
+        throw runtime_error("snapshot: invalid data offset.");
+    }
+
+    // check the data fits without overflow
+    uint64_t available = size_ > header.offset ? size_ - header.offset : 0;
+    if (header.count > available / value_size) {
+        throw runtime_error("snapshot: file truncated.");
+    }
+
+    return header;
+}
+
+
+const void*
+snapshot_mapping::data()
+const noexcept
+{
+    return data_;
+}
+
+
+size_t
+snapshot_mapping::size()
+const noexcept
+{
+    return size_;
+}
+
+// FUNCTIONS
+// ---------
+
+void
+write_snapshot_bytes(
+    const char* path,
+    const snapshot_header& header,
+    const void* data
+)
+{
+    // write to a temporary file in the same directory, so the rename
+    // over `path` is atomic, and readers only see complete snapshots.
+    std::string temp;
+    FILE* file = open_temporary(path, temp);
+
+    // header, zero padding up to the data offset, then the values
+    static const char zeros[64] = {};
+    size_t length = static_cast<size_t>(header.count * header.value_size);
+    size_t padding = static_cast<size_t>(header.offset) - sizeof(header);
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    while (ok && padding) {
+        size_t n = padding < sizeof(zeros) ? padding : sizeof(zeros);
+        ok = std::fwrite(zeros, 1, n, file) == n;
+        padding -= n;
+    }
+    if (ok && length) {
+        ok = std::fwrite(data, 1, length, file) == length;
+    }
+    ok = ok && std::fflush(file) == 0 && sync_file(file);
+
+    int code = errno;
+    if (std::fclose(file) != 0 && ok) {
+        code = errno;
+        ok = false;
+    }
+    if (!ok) {
+        std::remove(temp.c_str());
+        throw system_error(code, generic_category(), "snapshot: unable to write file");
+    }
+
+    replace_file(temp.c_str(), path);
+}
+
+PYCPP_END_NAMESPACE
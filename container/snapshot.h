@@ -0,0 +1,271 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Persistent, memory-mapped snapshots of contiguous containers.
+ *
+ *  Writes the elements of a contiguous container to a file in a
+ *  versioned layout, and reopens the file via `mmap` as a read-only
+ *  `const vector_facet<T>&`, without copying or re-parsing any
+ *  elements, so code written against the allocator-erased facet may
+ *  use the snapshot directly. Snapshots are written to a temporary
+ *  file, synced, and renamed over the target, so readers and crashes
+ *  never observe a partially-written file. The file header
+ *  records the element size, alignment and byte order, which are
+ *  validated on load.
+ *
+ *  Only types marked `is_snapshot_safe` may be persisted: by default,
+ *  trivially copyable types. Specialize the trait for types that use
+ *  position-independent (offset) pointers.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      struct is_snapshot_safe;
+ *
+ *      struct snapshot_header
+ *      {
+ *          char magic[8];
+ *          uint32_t version;
+ *          uint32_t byte_order;
+ *          uint64_t value_size;
+ *          uint64_t value_alignment;
+ *          uint64_t count;
+ *          uint64_t offset;
+ *          uint64_t reserved[2];
+ *      };
+ *
+ *      template <typename T>
+ *      class mapped_snapshot
+ *      {
+ *      public:
+ *          using facet_type = vector_facet<T>;
+ *
+ *          explicit mapped_snapshot(const char* path);
+ *          mapped_snapshot(mapped_snapshot&&) noexcept;
+ *          mapped_snapshot& operator=(mapped_snapshot&&) noexcept;
+ *          ~mapped_snapshot();
+ *
+ *          const snapshot_header& header() const noexcept;
+ *          const facet_type& facet() const noexcept;
+ *          operator const facet_type&() const noexcept;
+ *      };
+ *
+ *      template <typename T>
+ *      void write_snapshot(const char* path, const T* data, size_t size);
+ *
+ *      template <typename Container>
+ *      void write_snapshot(const char* path, const Container& c);
+ */
+
+#pragma once
+
+#include <pycpp/stl/cstdint.h>
+#include <pycpp/stl/container/vector.h>
+#include <pycpp/stl/stdexcept.h>
+#include <pycpp/stl/type_traits.h>
+#include <pycpp/stl/utility.h>
+#include <pycpp/stl/type_traits/endian.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+static constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+// OBJECTS
+// -------
+
+// TRAITS
+
+// Types which may be persisted bitwise and reloaded in another
+// process. Specialize for types with position-independent pointers.
+template <typename T>
+struct is_snapshot_safe: is_trivially_copyable<T>
+{};
+
+// HEADER
+
+struct snapshot_header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t value_size;
+    uint64_t value_alignment;
+    uint64_t count;
+    uint64_t offset;
+    uint64_t reserved[2];
+};
+
+static_assert(sizeof(snapshot_header) == 64, "Unexpected padding in snapshot_header.");
+
+// MAPPING
+
+// Type-erased, read-only file mapping.
+class snapshot_mapping
+{
+public:
+    snapshot_mapping() noexcept = default;
+    explicit snapshot_mapping(const char* path);
+    snapshot_mapping(const snapshot_mapping&) = delete;
+    snapshot_mapping& operator=(const snapshot_mapping&) = delete;
+    snapshot_mapping(snapshot_mapping&&) noexcept;
+    snapshot_mapping& operator=(snapshot_mapping&&) noexcept;
+    ~snapshot_mapping();
+
+    // Validate the header against the element layout and return it.
+    const snapshot_header& validate(size_t value_size, size_t value_alignment) const;
+
+    const void* data() const noexcept;
+    size_t size() const noexcept;
+
+private:
+    const void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// MAPPED SNAPSHOT
+
+template <typename T>
+class mapped_snapshot
+{
+public:
+    static_assert(is_snapshot_safe<T>::value, "Type cannot be loaded from a snapshot.");
+
+    using facet_type = vector_facet<T>;
+
+    mapped_snapshot(const mapped_snapshot&) = delete;
+    mapped_snapshot& operator=(const mapped_snapshot&) = delete;
+    ~mapped_snapshot() = default;
+
+    mapped_snapshot(
+        mapped_snapshot&& rhs
+    )
+    noexcept:
+        mapping_(move(rhs.mapping_)),
+        header_(rhs.header_),
+        facet_(rhs.facet_)
+    {
+        rhs.header_ = nullptr;
+        rhs.facet_ = facet_type();
+    }
+
+    mapped_snapshot&
+    operator=(
+        mapped_snapshot&& rhs
+    )
+    noexcept
+    {
+        // `rhs` releases the previous mapping
+        mapping_ = move(rhs.mapping_);
+        header_ = rhs.header_;
+        facet_ = rhs.facet_;
+        rhs.header_ = nullptr;
+        rhs.facet_ = facet_type();
+        return *this;
+    }
+
+    explicit
+    mapped_snapshot(
+        const char* path
+    ):
+        mapping_(path)
+    {
+        header_ = &mapping_.validate(sizeof(T), alignof(T));
+        auto first = static_cast<const char*>(mapping_.data()) + header_->offset;
+        // the facet is only exposed as const, so the mapping is never written
+        T* begin = const_cast<T*>(reinterpret_cast<const T*>(first));
+        facet_.begin_ = begin;
+        facet_.end_ = begin + header_->count;
+        facet_.end_cap_ = facet_.end_;
+    }
+
+    const snapshot_header&
+    header()
+    const noexcept
+    {
+        return *header_;
+    }
+
+    const facet_type&
+    facet()
+    const noexcept
+    {
+        return facet_;
+    }
+
+    operator const facet_type&()
+    const noexcept
+    {
+        return facet_;
+    }
+
+private:
+    snapshot_mapping mapping_;
+    const snapshot_header* header_ = nullptr;
+    facet_type facet_;
+};
+
+// FUNCTIONS
+// ---------
+
+// Write `header`, then the `header.count * header.value_size`
+// bytes at `data`, starting at `header.offset`, to a temporary
+// file which atomically replaces `path`.
+void
+write_snapshot_bytes(
+    const char* path,
+    const snapshot_header& header,
+    const void* data
+);
+
+template <typename T>
+snapshot_header
+make_snapshot_header(
+    size_t size
+)
+noexcept
+{
+    // Align the data to at least a cache-friendly 64-byte boundary,
+    // so mapped data keeps the element alignment within a page.
+    constexpr size_t alignment = alignof(T) > sizeof(snapshot_header) ? alignof(T) : sizeof(snapshot_header);
+
+    snapshot_header header = {
+        {'P', 'Y', 'S', 'N', 'A', 'P', '\0', '\0'},
+        SNAPSHOT_VERSION,
+        static_cast<uint32_t>(endian::native),
+        sizeof(T),
+        alignof(T),
+        size,
+        alignment,
+        {0, 0}
+    };
+    return header;
+}
+
+template <typename T>
+void
+write_snapshot(
+    const char* path,
+    const T* data,
+    size_t size
+)
+{
+    static_assert(is_snapshot_safe<T>::value, "Type cannot be written to a snapshot.");
+    write_snapshot_bytes(path, make_snapshot_header<T>(size), data);
+}
+
+template <typename Container>
+void
+write_snapshot(
+    const char* path,
+    const Container& c
+)
+{
+    using value_type = typename Container::value_type;
+    const value_type* data = c.data();
+    write_snapshot<value_type>(path, data, c.size());
+}
+
+PYCPP_END_NAMESPACE
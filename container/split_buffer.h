@@ -331,7 +331,12 @@ public:
     ):
         data_(facet_type(nullptr), a)
     {
-        facet().first_ = cap != 0 ? alloc_traits::allocate(alloc(), cap) : nullptr;
+        if (cap != 0) {
+            // record the capacity actually allocated
+            auto result = alloc_traits::allocate_at_least(alloc(), cap);
+            facet().first_ = result.ptr;
+            cap = result.count;
+        }
         facet().begin_ = facet().end_ = facet().first_ + start;
         facet().end_cap_ = facet().first_ + cap;
     }
@@ -514,11 +519,13 @@ public:
         size_type sz = size();
         size_type count = std::min(new_size-new_offset, sz);
 
-        // reallocate and calculate new buffer positions
-        pointer new_first = alloc_traits::reallocate(alloc(), facet().first_, capacity(), new_size, count, old_offset, new_offset);
+        // reallocate and calculate new buffer positions,
+        // recording the capacity actually allocated
+        auto result = alloc_traits::reallocate_at_least(alloc(), facet().first_, capacity(), new_size, count, old_offset, new_offset);
+        pointer new_first = result.ptr;
         pointer new_begin = new_first + new_offset;
         pointer new_end = new_begin + sz;
-        pointer new_cap = new_first + new_size;
+        pointer new_cap = new_first + result.count;
 
         // swap into new buffer
         fast_swap(facet().first_, new_first);
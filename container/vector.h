@@ -21,6 +21,7 @@
 #include <pycpp/stl/stdexcept.h>
 #include <pycpp/stl/utility.h>
 #include <pycpp/stl/container/split_buffer.h>
+#include <cstring>
 // TODO: need functional
 // TODO: remove std::
 
@@ -269,9 +270,9 @@ public:
     // TODO: add more methods
 
 private:
-    pointer begin_;
-    pointer end_;
-    pointer end_cap_;
+    pointer begin_ = nullptr;
+    pointer end_ = nullptr;
+    pointer end_cap_ = nullptr;
 
     // Modifiers
     void
@@ -285,6 +286,13 @@ private:
     }
 
     // TODO: private constructors, modifiers, etc...
+
+    template <typename, typename, intmax_t, intmax_t>
+    friend class vector;
+
+    // views the elements of a read-only file mapping
+    template <typename>
+    friend class mapped_snapshot;
 };
 
 // VECTOR
@@ -324,7 +332,46 @@ public:
     // TODO: add here...
 
     // Constructors
-    // TODO
+    vector() = default;
+
+    explicit
+    vector(
+        const allocator_type& a
+    ):
+        data_(a)
+    {}
+
+    // TODO: copy constructors, which require `select_on_container_copy_construction`
+    vector(const vector&) = delete;
+    vector& operator=(const vector&) = delete;
+
+    vector(
+        vector&& x
+    )
+    noexcept:
+        data_(move(x.alloc()))
+    {
+        facet().swap(x.facet());
+    }
+
+    vector&
+    operator=(
+        vector&& x
+    )
+    noexcept(alloc_traits::propagate_on_container_move_assignment::value)
+    {
+        using propagate = typename alloc_traits::propagate_on_container_move_assignment;
+        move_assign(x, integral_constant<bool, propagate::value>());
+        return *this;
+    }
+
+    ~vector()
+    {
+        clear();
+        if (facet().begin_ != nullptr) {
+            alloc_traits::deallocate(alloc(), facet().begin_, capacity());
+        }
+    }
 
     // Iterators
     iterator
@@ -584,6 +631,7 @@ public:
     {
         if (facet().end_ < facet().end_cap_) {
             alloc_traits::construct(alloc(), to_raw_pointer(facet().end_), x);
+            ++facet().end_;
         } else {
             push_back_slow(x);
         }
@@ -596,6 +644,7 @@ public:
     {
         if (facet().end_ < facet().end_cap_) {
             alloc_traits::construct(alloc(), to_raw_pointer(facet().end_), move(x));
+            ++facet().end_;
         } else {
             push_back_slow(move(x));
         }
@@ -609,6 +658,7 @@ public:
     {
         if (facet().end_ < facet().end_cap_) {
             alloc_traits::construct(alloc(), to_raw_pointer(facet().end_), forward<Ts>(ts)...);
+            ++facet().end_;
         } else {
             emplace_back_slow(forward<Ts>(ts)...);
         }
@@ -710,7 +760,8 @@ private:
             throw length_error("vector");
         }
 
-        // check with ideal growth rate
+        // check with ideal growth rate, from the capacity actually
+        // allocated, which may exceed what was previously requested
         const size_type cap = capacity();
         if (cap >= ms / ratio) {
             return ms;
@@ -718,7 +769,60 @@ private:
         return std::max<size_type>(ratio*cap, new_size);
     }
 
-    // TODO: need assign allocs...
+    // Move assign
+    void
+    move_assign(
+        vector& x,
+        true_type
+    )
+    noexcept
+    {
+        deallocate_buffer();
+        alloc() = move(x.alloc());
+        facet().swap(x.facet());
+    }
+
+    void
+    move_assign(
+        vector& x,
+        false_type
+    )
+    {
+        if (alloc() == x.alloc()) {
+            deallocate_buffer();
+            facet().swap(x.facet());
+            return;
+        }
+
+        // the storage belongs to `x`'s allocator, move the elements
+        clear();
+        size_type n = x.size();
+        if (capacity() < n) {
+            deallocate_buffer();
+            auto result = alloc_traits::allocate_at_least(alloc(), n);
+            facet().begin_ = result.ptr;
+            facet().end_ = result.ptr;
+            facet().end_cap_ = result.ptr + result.count;
+        }
+        allocator_type& a = alloc();
+        for (pointer p = x.facet().begin_; p != x.facet().end_; ++p) {
+            alloc_traits::construct(a, to_raw_pointer(facet().end_), move(*p));
+            ++facet().end_;
+        }
+    }
+
+    void
+    deallocate_buffer()
+    noexcept
+    {
+        if (facet().begin_ != nullptr) {
+            clear();
+            alloc_traits::deallocate(alloc(), facet().begin_, capacity());
+            facet().begin_ = nullptr;
+            facet().end_ = nullptr;
+            facet().end_cap_ = nullptr;
+        }
+    }
 
     // Object destruction
     void
@@ -756,10 +860,37 @@ private:
     }
 
     // Object construction
+    // Value-initialized elements may be zero-filled, unless the
+    // allocator customizes construction.
+    using is_zero_constructible = bool_constant<
+        is_zero_initializable<value_type>::value &&
+        !has_construct<allocator_type, value_type>::value
+    >;
+
     void
     construct_at_end(
         size_type n
     )
+    {
+        value_construct_at_end(n, is_zero_constructible());
+    }
+
+    void
+    value_construct_at_end(
+        size_type n,
+        true_type
+    )
+    noexcept
+    {
+        std::memset(static_cast<void*>(to_raw_pointer(facet().end_)), 0, n * sizeof(value_type));
+        facet().end_ += n;
+    }
+
+    void
+    value_construct_at_end(
+        size_type n,
+        false_type
+    )
     {
         allocator_type& a = alloc();
         do {
@@ -791,10 +922,7 @@ private:
         if (static_cast<size_type>(facet().end_cap_ - facet().end_) >= n) {
             construct_at_end(n);
         } else {
-            allocator_type& a = alloc();
-            buffer_type v(recommend(size() + n), size(), a);
-            v.construct_at_end(n);
-            swap_out_circular_buffer(v);
+            append_slow(n, is_relocatable<value_type>());
         }
     }
 
@@ -807,13 +935,90 @@ private:
         if (static_cast<size_type>(facet().end_cap_ - facet().end_) >= n) {
             construct_at_end(n, v);
         } else {
-            allocator_type& a = alloc();
-            buffer_type v(recommend(size() + n), size(), a);
-            v.construct_at_end(n, v);
-            swap_out_circular_buffer(v);
+            append_slow(n, v, is_relocatable<value_type>());
+        }
+    }
+
+    void
+    append_slow(
+        size_type n,
+        true_type
+    )
+    {
+        size_type cap = recommend(size() + n);
+        if (capacity() == 0 && is_zero_constructible::value) {
+            // the allocator may provide memory which is already zeroed
+            pointer p = alloc_traits::allocate_zeroed(alloc(), cap);
+            facet().begin_ = p;
+            facet().end_ = p + n;
+            facet().end_cap_ = p + cap;
+        } else {
+            reallocate_buffer(cap);
+            construct_at_end(n);
         }
     }
 
+    void
+    append_slow(
+        size_type n,
+        false_type
+    )
+    {
+        allocator_type& a = alloc();
+        buffer_type buf(recommend(size() + n), size(), a);
+        buf.construct_at_end(n);
+        swap_out_circular_buffer(buf);
+    }
+
+    void
+    append_slow(
+        size_type n,
+        const_reference v,
+        true_type
+    )
+    {
+        // `v` may alias the buffer, which `reallocate` can release
+        value_type x(v);
+        reallocate_buffer(recommend(size() + n));
+        construct_at_end(n, x);
+    }
+
+    void
+    append_slow(
+        size_type n,
+        const_reference v,
+        false_type
+    )
+    {
+        allocator_type& a = alloc();
+        buffer_type buf(recommend(size() + n), size(), a);
+        buf.construct_at_end(n, v);
+        swap_out_circular_buffer(buf);
+    }
+
+    // Reallocate buffer
+    // Grow the buffer for relocatable types through `alloc_traits::reallocate`,
+    // which allows the allocator or memory resource to extend it in-place.
+    void
+    reallocate_buffer(
+        size_type n
+    )
+    {
+        // record the capacity actually allocated, which may exceed `n`
+        allocator_type& a = alloc();
+        size_type cap = capacity();
+        size_type sz = size();
+        allocation_result<pointer, size_type> result;
+        if (cap == 0) {
+            result = alloc_traits::allocate_at_least(a, n);
+        } else {
+            result = alloc_traits::reallocate_at_least(a, facet().begin_, cap, n, sz);
+        }
+        facet().begin_ = result.ptr;
+        facet().end_ = result.ptr + sz;
+        facet().end_cap_ = result.ptr + result.count;
+    }
+
     // Swap out circular buffer
     void
     swap_out_circular_buffer(
@@ -852,11 +1057,7 @@ private:
         U&& x
     )
     {
-        allocator_type& a = alloc();
-        buffer_type v(recommend(size() + 1), size(), a);
-        alloc_traits::construct(a, to_raw_pointer(v.facet().end_), forward<U>(x));
-        v.facet().end_++;
-        swap_out_circular_buffer(v);
+        emplace_back_slow(forward<U>(x));
     }
 
     template <typename ... Ts>
@@ -864,6 +1065,31 @@ private:
     emplace_back_slow(
         Ts&&... ts
     )
+    {
+        emplace_back_slow_impl(is_relocatable<value_type>(), forward<Ts>(ts)...);
+    }
+
+    template <typename ... Ts>
+    void
+    emplace_back_slow_impl(
+        true_type,
+        Ts&&... ts
+    )
+    {
+        // the arguments may alias the buffer, which `reallocate`
+        // can release, so construct the value first.
+        value_type x(forward<Ts>(ts)...);
+        reallocate_buffer(recommend(size() + 1));
+        alloc_traits::construct(alloc(), to_raw_pointer(facet().end_), move(x));
+        facet().end_++;
+    }
+
+    template <typename ... Ts>
+    void
+    emplace_back_slow_impl(
+        false_type,
+        Ts&&... ts
+    )
     {
         allocator_type& a = alloc();
         buffer_type v(recommend(size() + 1), size(), a);
@@ -888,4 +1114,8 @@ struct is_relocatable<vector<T, Allocator>>:
     >
 {};
 
+template <typename T, typename Allocator, intmax_t Num, intmax_t Den>
+struct hash<vector<T, Allocator, Num, Den>>: contiguous_hash<vector<T, Allocator, Num, Den>>
+{};
+
 PYCPP_END_NAMESPACE
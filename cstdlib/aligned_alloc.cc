@@ -4,9 +4,12 @@
 #include <pycpp/preprocessor/compiler_traits.h>
 #include <pycpp/stl/cstdlib/aligned_alloc.h>
 #include <algorithm>
+#include <cstddef>
 #include <cstring>
-#if defined(PYCPP_MSVC)
+#if defined(PYCPP_WINDOWS) || defined(__GLIBC__)
 #   include <malloc.h>
+#elif defined(__APPLE__)
+#   include <malloc/malloc.h>
 #endif
 
 PYCPP_BEGIN_NAMESPACE
@@ -70,7 +73,7 @@ aligned_alloc(
 void*
 aligned_realloc(
    void *p,
-   std::size_t alignment
+   std::size_t alignment,
    std::size_t /*old_size*/,
    std::size_t new_size
 )
@@ -88,9 +91,11 @@ aligned_realloc(
    std::size_t new_size
 )
 {
-    // TODO(ahuszagh)
-    // Wishlist. Optimize this routine to allow more efficiency
-    // than an aligned_alloc + memcpy, allow grow, etc.
+    // Memory from `aligned_alloc` may be passed to `realloc`, which
+    // guarantees the fundamental alignment and may grow in-place.
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::realloc(p, new_size);
+    }
 
     void* pout = aligned_alloc(alignment, new_size);
     // If the allocator returns null, don't free the pointer and return NULL
@@ -159,4 +164,56 @@ aligned_free(
 
 #endif                                                      // HAVE_ALIGNED_ALLOC
 
+// ALIGNED USABLE SIZE
+
+#if defined(PYCPP_WINDOWS)                                  // WINDOWS
+
+std::size_t
+aligned_usable_size(
+    void* p,
+    std::size_t alignment,
+    std::size_t
+)
+{
+    return _aligned_msize(p, alignment, 0);
+}
+
+#elif defined(__GLIBC__)                                    // GLIBC
+
+std::size_t
+aligned_usable_size(
+    void* p,
+    std::size_t,
+    std::size_t
+)
+{
+    return malloc_usable_size(p);
+}
+
+#elif defined(__APPLE__)                                    // APPLE
+
+std::size_t
+aligned_usable_size(
+    void* p,
+    std::size_t,
+    std::size_t
+)
+{
+    return malloc_size(p);
+}
+
+#else                                                       // OTHER
+
+std::size_t
+aligned_usable_size(
+    void*,
+    std::size_t,
+    std::size_t size
+)
+{
+    return size;
+}
+
+#endif                                                      // WINDOWS
+
 PYCPP_END_NAMESPACE
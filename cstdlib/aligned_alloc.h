@@ -8,6 +8,7 @@
  *      void* aligned_alloc(std::size_t alignment, std::size_t size);
  *      void* aligned_realloc(void* p, std::size_t alignment, std::size_t old_size, std::size_t new_size);
  *      void aligned_free(void* p);
+ *      std::size_t aligned_usable_size(void* p, std::size_t alignment, std::size_t size);
  */
 
 #pragma once
@@ -59,4 +60,13 @@ aligned_free(
     void* p
 );
 
+// Usable size of a block from `aligned_alloc`, which may exceed the
+// requested `size`. Returns `size` if the platform cannot query it.
+std::size_t
+aligned_usable_size(
+    void* p,
+    std::size_t alignment,
+    std::size_t size
+);
+
 PYCPP_END_NAMESPACE
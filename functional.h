@@ -13,12 +13,16 @@
 #include <pycpp/stl/functional/bit_not.h>
 #include <pycpp/stl/functional/boyer_moore_horspool_searcher.h>
 #include <pycpp/stl/functional/boyer_moore_searcher.h>
+#include <pycpp/stl/functional/constexpr_hash.h>
 #include <pycpp/stl/functional/default_searcher.h>
 #include <pycpp/stl/functional/divides.h>
 #include <pycpp/stl/functional/equal_to.h>
 #include <pycpp/stl/functional/greater.h>
 #include <pycpp/stl/functional/greater_equal.h>
 #include <pycpp/stl/functional/hash.h>
+#include <pycpp/stl/functional/hash_append.h>
+#include <pycpp/stl/functional/hash_batch.h>
+#include <pycpp/stl/functional/hash_state.h>
 #include <pycpp/stl/functional/invoke.h>
 #include <pycpp/stl/functional/less.h>
 #include <pycpp/stl/functional/less_equal.h>
@@ -26,12 +30,14 @@
 #include <pycpp/stl/functional/logical_not.h>
 #include <pycpp/stl/functional/logical_or.h>
 #include <pycpp/stl/functional/minus.h>
+#include <pycpp/stl/functional/mixing_hash.h>
 #include <pycpp/stl/functional/modulus.h>
 #include <pycpp/stl/functional/multiplies.h>
 #include <pycpp/stl/functional/negate.h>
 #include <pycpp/stl/functional/not_equal_to.h>
 #include <pycpp/stl/functional/not_fn.h>
 #include <pycpp/stl/functional/plus.h>
+#include <pycpp/stl/functional/xxh3.h>
 
 PYCPP_BEGIN_NAMESPACE
 
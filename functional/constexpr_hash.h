@@ -0,0 +1,598 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Compile-time string hashes, identical to `hash_string`.
+ *
+ *  `constexpr` implementations of XXH32, XXH64 and XXH3-64, producing
+ *  the same hashes as the runtime implementations for the same seed.
+ *  `constexpr_hash_string` selects the same algorithm and seed as
+ *  `hash_string`, so a hash computed at compile time may be compared
+ *  against `hash` of a string at runtime, for example, to dispatch on
+ *  string keys with a `switch`, or to build perfect-hash tables of
+ *  string literals. The `_hash` literal, in `literals::hash_literals`,
+ *  is shorthand for `constexpr_hash_string`:
+ *
+ *      switch (hash_string(name.data(), name.size())) {
+ *          case "open"_hash:
+ *              ...
+ *      }
+ *
+ *  These require relaxed `constexpr` functions, and are only
+ *  available from C++14. They read the input one byte at a time, so
+ *  prefer `hash_string` for strings only known at runtime.
+ *
+ *  \synopsis
+ *      #ifdef PYCPP_CPP14
+ *
+ *      constexpr uint32_t constexpr_xxh32(const char* buffer, size_t size, uint32_t seed) noexcept;
+ *      constexpr uint64_t constexpr_xxh64(const char* buffer, size_t size, uint64_t seed) noexcept;
+ *      constexpr uint64_t constexpr_xxh3_64(const char* buffer, size_t size, uint64_t seed = 0) noexcept;
+ *      constexpr hash_result_t constexpr_hash_string(const char* buffer, size_t size) noexcept;
+ *
+ *      namespace literals
+ *      {
+ *      namespace hash_literals
+ *      {
+ *      constexpr size_t operator"" _hash(const char* buffer, size_t size) noexcept;
+ *      }
+ *      }
+ *
+ *      #endif
+ */
+
+#pragma once
+
+#include <pycpp/stl/functional/hash.h>
+#include <pycpp/stl/functional/xxh3.h>
+#include <cstddef>
+#include <cstdint>
+
+PYCPP_BEGIN_NAMESPACE
+
+#if defined(PYCPP_CPP14)            // CPP14
+
+// CONSTANTS
+// ---------
+
+constexpr uint32_t CONSTEXPR_PRIME32_1 = 0x9E3779B1U;
+constexpr uint32_t CONSTEXPR_PRIME32_2 = 0x85EBCA77U;
+constexpr uint32_t CONSTEXPR_PRIME32_3 = 0xC2B2AE3DU;
+constexpr uint32_t CONSTEXPR_PRIME32_4 = 0x27D4EB2FU;
+constexpr uint32_t CONSTEXPR_PRIME32_5 = 0x165667B1U;
+constexpr uint64_t CONSTEXPR_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t CONSTEXPR_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t CONSTEXPR_PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t CONSTEXPR_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t CONSTEXPR_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+constexpr uint64_t CONSTEXPR_PRIME_MX1 = 0x165667919E3779F9ULL;
+constexpr uint64_t CONSTEXPR_PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+// HELPERS
+// -------
+
+template <typename Byte>
+constexpr
+uint32_t
+constexpr_read32(
+    const Byte* p
+)
+noexcept
+{
+    return static_cast<uint32_t>(static_cast<uint8_t>(p[0])) |
+        (static_cast<uint32_t>(static_cast<uint8_t>(p[1])) << 8) |
+        (static_cast<uint32_t>(static_cast<uint8_t>(p[2])) << 16) |
+        (static_cast<uint32_t>(static_cast<uint8_t>(p[3])) << 24);
+}
+
+
+template <typename Byte>
+constexpr
+uint64_t
+constexpr_read64(
+    const Byte* p
+)
+noexcept
+{
+    return static_cast<uint64_t>(constexpr_read32(p)) |
+        (static_cast<uint64_t>(constexpr_read32(p + 4)) << 32);
+}
+
+
+constexpr
+uint32_t
+constexpr_rotl32(
+    uint32_t x,
+    int r
+)
+noexcept
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+
+constexpr
+uint64_t
+constexpr_rotl64(
+    uint64_t x,
+    int r
+)
+noexcept
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+
+constexpr
+uint32_t
+constexpr_swap32(
+    uint32_t x
+)
+noexcept
+{
+    return ((x << 24) & 0xFF000000) | ((x << 8) & 0x00FF0000) |
+        ((x >> 8) & 0x0000FF00) | ((x >> 24) & 0x000000FF);
+}
+
+
+constexpr
+uint64_t
+constexpr_swap64(
+    uint64_t x
+)
+noexcept
+{
+    return (static_cast<uint64_t>(constexpr_swap32(static_cast<uint32_t>(x))) << 32) |
+        constexpr_swap32(static_cast<uint32_t>(x >> 32));
+}
+
+
+// Fold the 128-bit product of two 64-bit values, from 32-bit halves.
+constexpr
+uint64_t
+constexpr_mul128_fold64(
+    uint64_t x,
+    uint64_t y
+)
+noexcept
+{
+    uint64_t lo_lo = (x & 0xFFFFFFFF) * (y & 0xFFFFFFFF);
+    uint64_t hi_lo = (x >> 32) * (y & 0xFFFFFFFF);
+    uint64_t lo_hi = (x & 0xFFFFFFFF) * (y >> 32);
+    uint64_t hi_hi = (x >> 32) * (y >> 32);
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+    return lower ^ upper;
+}
+
+// XXH32
+
+constexpr
+uint32_t
+constexpr_xxh32_round(
+    uint32_t acc,
+    uint32_t input
+)
+noexcept
+{
+    return constexpr_rotl32(acc + input * CONSTEXPR_PRIME32_2, 13) * CONSTEXPR_PRIME32_1;
+}
+
+// XXH64
+
+constexpr
+uint64_t
+constexpr_xxh64_round(
+    uint64_t acc,
+    uint64_t input
+)
+noexcept
+{
+    return constexpr_rotl64(acc + input * CONSTEXPR_PRIME64_2, 31) * CONSTEXPR_PRIME64_1;
+}
+
+
+constexpr
+uint64_t
+constexpr_xxh64_merge(
+    uint64_t acc,
+    uint64_t value
+)
+noexcept
+{
+    acc ^= constexpr_xxh64_round(0, value);
+    return acc * CONSTEXPR_PRIME64_1 + CONSTEXPR_PRIME64_4;
+}
+
+
+constexpr
+uint64_t
+constexpr_xxh64_avalanche(
+    uint64_t h
+)
+noexcept
+{
+    h ^= h >> 33;
+    h *= CONSTEXPR_PRIME64_2;
+    h ^= h >> 29;
+    h *= CONSTEXPR_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+// XXH3
+
+constexpr
+uint64_t
+constexpr_xxh3_avalanche(
+    uint64_t h
+)
+noexcept
+{
+    h ^= h >> 37;
+    h *= CONSTEXPR_PRIME_MX1;
+    return h ^ (h >> 32);
+}
+
+
+constexpr
+uint64_t
+constexpr_xxh3_mix16(
+    const char* input,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    uint64_t lo = constexpr_read64(input) ^ (constexpr_read64(secret) + seed);
+    uint64_t hi = constexpr_read64(input + 8) ^ (constexpr_read64(secret + 8) - seed);
+    return constexpr_mul128_fold64(lo, hi);
+}
+
+
+constexpr
+uint64_t
+constexpr_xxh3_0to16(
+    const char* input,
+    size_t len,
+    uint64_t seed
+)
+noexcept
+{
+    const uint8_t* secret = xxh3_secret;
+    if (len > 8) {
+        uint64_t bitflip1 = (constexpr_read64(secret + 24) ^ constexpr_read64(secret + 32)) + seed;
+        uint64_t bitflip2 = (constexpr_read64(secret + 40) ^ constexpr_read64(secret + 48)) - seed;
+        uint64_t lo = constexpr_read64(input) ^ bitflip1;
+        uint64_t hi = constexpr_read64(input + len - 8) ^ bitflip2;
+        uint64_t acc = len + constexpr_swap64(lo) + hi + constexpr_mul128_fold64(lo, hi);
+        return constexpr_xxh3_avalanche(acc);
+    } else if (len >= 4) {
+        seed ^= static_cast<uint64_t>(constexpr_swap32(static_cast<uint32_t>(seed))) << 32;
+        uint64_t input1 = constexpr_read32(input);
+        uint64_t input2 = constexpr_read32(input + len - 4);
+        uint64_t bitflip = (constexpr_read64(secret + 8) ^ constexpr_read64(secret + 16)) - seed;
+        uint64_t h = (input2 + (input1 << 32)) ^ bitflip;
+        h ^= constexpr_rotl64(h, 49) ^ constexpr_rotl64(h, 24);
+        h *= CONSTEXPR_PRIME_MX2;
+        h ^= (h >> 35) + len;
+        h *= CONSTEXPR_PRIME_MX2;
+        return h ^ (h >> 28);
+    } else if (len) {
+        uint32_t c1 = static_cast<uint8_t>(input[0]);
+        uint32_t c2 = static_cast<uint8_t>(input[len >> 1]);
+        uint32_t c3 = static_cast<uint8_t>(input[len - 1]);
+        uint32_t combined = (c1 << 16) | (c2 << 24) | c3 | (static_cast<uint32_t>(len) << 8);
+        uint64_t bitflip = (constexpr_read32(secret) ^ constexpr_read32(secret + 4)) + seed;
+        return constexpr_xxh64_avalanche(combined ^ bitflip);
+    }
+    return constexpr_xxh64_avalanche(seed ^ (constexpr_read64(secret + 56) ^ constexpr_read64(secret + 64)));
+}
+
+
+constexpr
+uint64_t
+constexpr_xxh3_17to128(
+    const char* input,
+    size_t len,
+    uint64_t seed
+)
+noexcept
+{
+    const uint8_t* secret = xxh3_secret;
+    uint64_t acc = len * CONSTEXPR_PRIME64_1;
+    if (len > 32) {
+        if (len > 64) {
+            if (len > 96) {
+                acc += constexpr_xxh3_mix16(input + 48, secret + 96, seed);
+                acc += constexpr_xxh3_mix16(input + len - 64, secret + 112, seed);
+            }
+            acc += constexpr_xxh3_mix16(input + 32, secret + 64, seed);
+            acc += constexpr_xxh3_mix16(input + len - 48, secret + 80, seed);
+        }
+        acc += constexpr_xxh3_mix16(input + 16, secret + 32, seed);
+        acc += constexpr_xxh3_mix16(input + len - 32, secret + 48, seed);
+    }
+    acc += constexpr_xxh3_mix16(input, secret, seed);
+    acc += constexpr_xxh3_mix16(input + len - 16, secret + 16, seed);
+
+    return constexpr_xxh3_avalanche(acc);
+}
+
+
+constexpr
+uint64_t
+constexpr_xxh3_129to240(
+    const char* input,
+    size_t len,
+    uint64_t seed
+)
+noexcept
+{
+    const uint8_t* secret = xxh3_secret;
+    uint64_t acc = len * CONSTEXPR_PRIME64_1;
+    size_t rounds = len / 16;
+    for (size_t i = 0; i < 8; ++i) {
+        acc += constexpr_xxh3_mix16(input + 16 * i, secret + 16 * i, seed);
+    }
+    // MIDSIZE_LASTOFFSET is 17, and SECRET_SIZE_MIN is 136
+    uint64_t acc_end = constexpr_xxh3_mix16(input + len - 16, secret + 136 - 17, seed);
+    acc = constexpr_xxh3_avalanche(acc);
+    // MIDSIZE_STARTOFFSET is 3
+    for (size_t i = 8; i < rounds; ++i) {
+        acc_end += constexpr_xxh3_mix16(input + 16 * i, secret + 16 * (i - 8) + 3, seed);
+    }
+
+    return constexpr_xxh3_avalanche(acc + acc_end);
+}
+
+
+constexpr
+void
+constexpr_xxh3_accumulate(
+    uint64_t* acc,
+    const char* input,
+    const uint8_t* secret
+)
+noexcept
+{
+    for (size_t i = 0; i < 8; ++i) {
+        uint64_t data = constexpr_read64(input + 8 * i);
+        uint64_t data_key = data ^ constexpr_read64(secret + 8 * i);
+        acc[i ^ 1] += data;
+        acc[i] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+    }
+}
+
+
+constexpr
+uint64_t
+constexpr_xxh3_long(
+    const char* input,
+    size_t len,
+    uint64_t seed
+)
+noexcept
+{
+    uint64_t acc[8] = {
+        CONSTEXPR_PRIME32_3, CONSTEXPR_PRIME64_1, CONSTEXPR_PRIME64_2, CONSTEXPR_PRIME64_3,
+        CONSTEXPR_PRIME64_4, CONSTEXPR_PRIME32_2, CONSTEXPR_PRIME64_5, CONSTEXPR_PRIME32_1
+    };
+
+    // derive the secret from the seed, as bytes, since it is read at
+    // unaligned offsets
+    uint8_t secret[192] = {};
+    for (size_t i = 0; i < 192; i += 8) {
+        uint64_t word = constexpr_read64(xxh3_secret + i);
+        word = (i % 16 == 0) ? word + seed : word - seed;
+        for (size_t j = 0; j < 8; ++j) {
+            secret[i + j] = static_cast<uint8_t>(word >> (8 * j));
+        }
+    }
+
+    // 16 stripes of 64 bytes per block, scrambling after each block
+    size_t block_len = 64 * 16;
+    size_t blocks = (len - 1) / block_len;
+    for (size_t n = 0; n < blocks; ++n) {
+        for (size_t s = 0; s < 16; ++s) {
+            constexpr_xxh3_accumulate(acc, input + n * block_len + 64 * s, secret + 8 * s);
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            uint64_t a = acc[i] ^ (acc[i] >> 47);
+            a ^= constexpr_read64(secret + 192 - 64 + 8 * i);
+            acc[i] = a * CONSTEXPR_PRIME32_1;
+        }
+    }
+
+    // last partial block, and the last stripe
+    size_t stripes = ((len - 1) - (block_len * blocks)) / 64;
+    for (size_t s = 0; s < stripes; ++s) {
+        constexpr_xxh3_accumulate(acc, input + blocks * block_len + 64 * s, secret + 8 * s);
+    }
+    constexpr_xxh3_accumulate(acc, input + len - 64, secret + 192 - 64 - 7);
+
+    // merge the accumulators
+    uint64_t result = len * CONSTEXPR_PRIME64_1;
+    for (size_t i = 0; i < 4; ++i) {
+        const uint8_t* key = secret + 11 + 16 * i;
+        result += constexpr_mul128_fold64(acc[2 * i] ^ constexpr_read64(key), acc[2 * i + 1] ^ constexpr_read64(key + 8));
+    }
+    return constexpr_xxh3_avalanche(result);
+}
+
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief Compile-time XXH32, identical to `XXH32`.
+ */
+constexpr
+uint32_t
+constexpr_xxh32(
+    const char* buffer,
+    size_t size,
+    uint32_t seed
+)
+noexcept
+{
+    const char* p = buffer;
+    const char* end = buffer + size;
+    uint32_t h = 0;
+    if (size >= 16) {
+        uint32_t v1 = seed + CONSTEXPR_PRIME32_1 + CONSTEXPR_PRIME32_2;
+        uint32_t v2 = seed + CONSTEXPR_PRIME32_2;
+        uint32_t v3 = seed;
+        uint32_t v4 = seed - CONSTEXPR_PRIME32_1;
+        for (; p + 16 <= end; p += 16) {
+            v1 = constexpr_xxh32_round(v1, constexpr_read32(p));
+            v2 = constexpr_xxh32_round(v2, constexpr_read32(p + 4));
+            v3 = constexpr_xxh32_round(v3, constexpr_read32(p + 8));
+            v4 = constexpr_xxh32_round(v4, constexpr_read32(p + 12));
+        }
+        h = constexpr_rotl32(v1, 1) + constexpr_rotl32(v2, 7) + constexpr_rotl32(v3, 12) + constexpr_rotl32(v4, 18);
+    } else {
+        h = seed + CONSTEXPR_PRIME32_5;
+    }
+
+    h += static_cast<uint32_t>(size);
+    for (; p + 4 <= end; p += 4) {
+        h += constexpr_read32(p) * CONSTEXPR_PRIME32_3;
+        h = constexpr_rotl32(h, 17) * CONSTEXPR_PRIME32_4;
+    }
+    for (; p < end; ++p) {
+        h += static_cast<uint8_t>(*p) * CONSTEXPR_PRIME32_5;
+        h = constexpr_rotl32(h, 11) * CONSTEXPR_PRIME32_1;
+    }
+
+    h ^= h >> 15;
+    h *= CONSTEXPR_PRIME32_2;
+    h ^= h >> 13;
+    h *= CONSTEXPR_PRIME32_3;
+    h ^= h >> 16;
+    return h;
+}
+
+
+/**
+ *  \brief Compile-time XXH64, identical to `XXH64`.
+ */
+constexpr
+uint64_t
+constexpr_xxh64(
+    const char* buffer,
+    size_t size,
+    uint64_t seed
+)
+noexcept
+{
+    const char* p = buffer;
+    const char* end = buffer + size;
+    uint64_t h = 0;
+    if (size >= 32) {
+        uint64_t v1 = seed + CONSTEXPR_PRIME64_1 + CONSTEXPR_PRIME64_2;
+        uint64_t v2 = seed + CONSTEXPR_PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - CONSTEXPR_PRIME64_1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = constexpr_xxh64_round(v1, constexpr_read64(p));
+            v2 = constexpr_xxh64_round(v2, constexpr_read64(p + 8));
+            v3 = constexpr_xxh64_round(v3, constexpr_read64(p + 16));
+            v4 = constexpr_xxh64_round(v4, constexpr_read64(p + 24));
+        }
+        h = constexpr_rotl64(v1, 1) + constexpr_rotl64(v2, 7) + constexpr_rotl64(v3, 12) + constexpr_rotl64(v4, 18);
+        h = constexpr_xxh64_merge(h, v1);
+        h = constexpr_xxh64_merge(h, v2);
+        h = constexpr_xxh64_merge(h, v3);
+        h = constexpr_xxh64_merge(h, v4);
+    } else {
+        h = seed + CONSTEXPR_PRIME64_5;
+    }
+
+    h += static_cast<uint64_t>(size);
+    for (; p + 8 <= end; p += 8) {
+        h ^= constexpr_xxh64_round(0, constexpr_read64(p));
+        h = constexpr_rotl64(h, 27) * CONSTEXPR_PRIME64_1 + CONSTEXPR_PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(constexpr_read32(p)) * CONSTEXPR_PRIME64_1;
+        h = constexpr_rotl64(h, 23) * CONSTEXPR_PRIME64_2 + CONSTEXPR_PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= static_cast<uint8_t>(*p) * CONSTEXPR_PRIME64_5;
+        h = constexpr_rotl64(h, 11) * CONSTEXPR_PRIME64_1;
+    }
+
+    return constexpr_xxh64_avalanche(h);
+}
+
+
+/**
+ *  \brief Compile-time XXH3-64, identical to `xxh3_64`.
+ */
+constexpr
+uint64_t
+constexpr_xxh3_64(
+    const char* buffer,
+    size_t size,
+    uint64_t seed = 0
+)
+noexcept
+{
+    if (size <= 16) {
+        return constexpr_xxh3_0to16(buffer, size, seed);
+    } else if (size <= 128) {
+        return constexpr_xxh3_17to128(buffer, size, seed);
+    } else if (size <= 240) {
+        return constexpr_xxh3_129to240(buffer, size, seed);
+    }
+    return constexpr_xxh3_long(buffer, size, seed);
+}
+
+
+/**
+ *  \brief Compile-time `hash_string`.
+ */
+constexpr
+hash_result_t
+constexpr_hash_string(
+    const char* buffer,
+    size_t size
+)
+noexcept
+{
+#if PYCPP_SYSTEM_ARCHITECTURE <= 32             // 32-bit
+    return constexpr_xxh32(buffer, size, HASH_SEED);
+#elif defined(PYCPP_HASH_LEGACY)                // 64-bit, legacy
+    return constexpr_xxh64(buffer, size, HASH_SEED);
+#else                                           // 64-bit
+    return constexpr_xxh3_64(buffer, size, HASH_SEED);
+#endif                                          // Hash size
+}
+
+// LITERALS
+// --------
+
+namespace literals
+{
+namespace hash_literals
+{
+
+constexpr
+size_t
+operator"" _hash(
+    const char* buffer,
+    size_t size
+)
+noexcept
+{
+    return static_cast<size_t>(constexpr_hash_string(buffer, size));
+}
+
+}   /* hash_literals */
+}   /* literals */
+
+#endif                              // CPP14
+
+PYCPP_END_NAMESPACE
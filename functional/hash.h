@@ -11,6 +11,14 @@
  *  xxHash is faster than all existing STL hash functions, at the cost
  *  of some additional memory overhead [1].
  *
+ *  On 64-bit systems, strings are hashed with XXH3, which is several
+ *  times faster than XXH64 for short keys. Defining `PYCPP_HASH_LEGACY`
+ *  keeps XXH64, for hashes persisted by earlier versions.
+ *
+ *  Classes and arrays that are trivially hashable, where equal values
+ *  have equal bytes, are hashed with a single call over their bytes,
+ *  as are contiguous containers of such types.
+ *
  *  1. https://github.com/Cyan4973/xxHash
  *
  *  \synopsis
@@ -21,6 +29,9 @@
  *
  *      hash_result_t hash_string(const void* buffer, size_t size) noexcept;
  *
+ *      template <typename Range>
+ *      struct contiguous_hash;
+ *
  *      template <typename T>
  *      struct hash;
  */
@@ -30,7 +41,9 @@
 #include <pycpp/preprocessor/architecture.h>
 #include <pycpp/preprocessor/compiler.h>
 #include <pycpp/stl/functional/hash_specialize.h>
+#include <pycpp/stl/functional/xxh3.h>
 #include <pycpp/stl/functional/xxhash_c.h>
+#include <pycpp/stl/type_traits/is_trivially_hashable.h>
 #include <type_traits>
 
 PYCPP_BEGIN_NAMESPACE
@@ -70,8 +83,10 @@ noexcept
 {
 #if defined(PYCPP_USE_HASH32)               // 32-bit
     return XXH32(buffer, size, HASH_SEED);
-#elif defined(PYCPP_USE_HASH64)             // 64-bit
+#elif defined(PYCPP_USE_HASH64) && defined(PYCPP_HASH_LEGACY)     // 64-bit, legacy
     return XXH64(buffer, size, HASH_SEED);
+#elif defined(PYCPP_USE_HASH64)             // 64-bit
+    return xxh3_64(buffer, size, HASH_SEED);
 #else                                       // Unsupported
 #   error "Unsupported system architecture."
 #endif                                      // Hash size
@@ -92,6 +107,7 @@ noexcept
     {                                                                                       \
         using argument_type = type;                                                         \
         using result_type = size_t;                                                         \
+        using is_avalanching = std::true_type;                                              \
                                                                                             \
         size_t                                                                              \
         operator()(                                                                         \
@@ -188,10 +204,69 @@ struct enum_hash<T, false>
     enum_hash& operator=(const enum_hash&) = delete;
 };
 
+// TRIVIAL HASH
+
+// Classes and arrays, hashed by their bytes.
+template <
+    typename T,
+    bool = is_trivially_hashable<T>::value && (std::is_class<T>::value || std::is_array<T>::value)
+>
+struct trivial_hash
+{
+    using argument_type = T;
+    using result_type = size_t;
+    using is_avalanching = std::true_type;
+
+    size_t
+    operator()(
+        const T& x
+    )
+    const noexcept
+    {
+        return hash_string(&x, sizeof(T));
+    }
+};
+
+template <typename T>
+struct trivial_hash<T, false>: public enum_hash<T>
+{};
+
+// CONTIGUOUS HASH
+
+// Contiguous ranges of trivially hashable types, hashed by their bytes.
+template <
+    typename Range,
+    bool = is_trivially_hashable<typename Range::value_type>::value
+>
+struct contiguous_hash
+{
+    using argument_type = Range;
+    using result_type = size_t;
+    using is_avalanching = std::true_type;
+
+    size_t
+    operator()(
+        const Range& x
+    )
+    const noexcept
+    {
+        using value_type = typename Range::value_type;
+        return hash_string(x.data(), x.size() * sizeof(value_type));
+    }
+};
+
+template <typename Range>
+struct contiguous_hash<Range, false>
+{
+    contiguous_hash() = delete;
+    contiguous_hash(const contiguous_hash&) = delete;
+    contiguous_hash& operator=(const contiguous_hash&) = delete;
+};
+
 // HASH
 
 template <typename T>
-struct hash: public enum_hash<T>
+struct hash: public trivial_hash<T>
 {};
 
 // CLEANUP
@@ -0,0 +1,438 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Append values to a `hash_state`, to hash composite keys.
+ *
+ *  `hash_append(state, value)` feeds the bytes representing `value`
+ *  into a `hash_state`, so a key made of several fields is hashed in
+ *  a single pass, rather than combining the hashes of each field.
+ *  Overloads are provided for arithmetic, enum and pointer types,
+ *  strings, pairs, tuples, and sequence containers, such as `vector`,
+ *  `deque`, `list`, `forward_list` and `array`. Strings and containers
+ *  append their size after their elements, so `("ab", "c")` and
+ *  `("a", "bc")` hash differently. Unordered containers are excluded,
+ *  since equal containers may iterate in different orders.
+ *
+ *  Trivially hashable classes and arrays, and contiguous containers of
+ *  trivially hashable types, are appended in a single update over their
+ *  bytes.
+ *
+ *  User-defined types are supported by declaring `hash_append` in the
+ *  namespace of the type, which is found by argument-dependent lookup:
+ *
+ *      void hash_append(hash_state& state, const point& p) noexcept
+ *      {
+ *          hash_append(state, p.x);
+ *          hash_append(state, p.y);
+ *      }
+ *
+ *  `hash_combine(ts...)` hashes all arguments into a single value, and
+ *  `hash` is specialized for `pair` and `tuple` in terms of
+ *  `hash_append`.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      void hash_append(hash_state& state, const T& x) noexcept;               // arithmetic, enum, pointer
+ *
+ *      template <typename T>
+ *      void hash_append(hash_state& state, const T& x) noexcept;               // trivially hashable
+ *
+ *      template <typename C, typename Tr, typename A>
+ *      void hash_append(hash_state& state, const basic_string<C, Tr, A>& x) noexcept;
+ *
+ *      template <typename T1, typename T2>
+ *      void hash_append(hash_state& state, const pair<T1, T2>& x) noexcept;
+ *
+ *      template <typename ... Ts>
+ *      void hash_append(hash_state& state, const tuple<Ts...>& x) noexcept;
+ *
+ *      template <typename Range>
+ *      void hash_append(hash_state& state, const Range& x) noexcept;          // sequence containers
+ *
+ *      template <typename ... Ts>
+ *      size_t hash_combine(const Ts&... ts) noexcept;
+ *
+ *      template <typename T1, typename T2>
+ *      struct hash<pair<T1, T2>>;
+ *
+ *      template <typename ... Ts>
+ *      struct hash<tuple<Ts...>>;
+ */
+
+#pragma once
+
+#include <pycpp/stl/functional/hash_state.h>
+#include <pycpp/stl/tuple.h>
+#include <pycpp/stl/type_traits/is_trivially_hashable.h>
+#include <pycpp/stl/utility/integer_sequence.h>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+PYCPP_BEGIN_NAMESPACE
+
+// HELPERS
+// -------
+
+template <typename T>
+using hash_append_scalar = std::integral_constant<
+    bool,
+    std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value
+>;
+
+// Classes and arrays appended by their bytes.
+template <typename T>
+using hash_append_trivial = std::integral_constant<
+    bool,
+    is_trivially_hashable<T>::value && (std::is_class<T>::value || std::is_array<T>::value)
+>;
+
+// Ordered ranges, excluding strings, unordered containers, and types
+// appended by their bytes.
+template <typename T>
+struct hash_append_range
+{
+    template <typename U>
+    static
+    auto
+    test(
+        int
+    )
+    -> decltype(std::begin(std::declval<const U&>()) != std::end(std::declval<const U&>()), std::true_type());
+
+    template <typename U>
+    static
+    std::false_type
+    test(
+        ...
+    );
+
+    template <typename U>
+    static
+    std::true_type
+    unordered(
+        typename U::key_equal*
+    );
+
+    template <typename U>
+    static
+    std::false_type
+    unordered(
+        ...
+    );
+
+    static constexpr bool value = decltype(test<T>(0))::value &&
+        !decltype(unordered<T>(nullptr))::value &&
+        !hash_append_trivial<T>::value;
+};
+
+template <typename C, typename Tr, typename A>
+struct hash_append_range<std::basic_string<C, Tr, A>>: std::false_type
+{};
+
+// Contiguous ranges of trivially hashable types.
+template <typename T>
+struct hash_append_contiguous
+{
+    template <typename U>
+    static
+    auto
+    test(
+        int
+    )
+    -> decltype(std::declval<const U&>().size(), std::integral_constant<
+            bool,
+            std::is_pointer<decltype(std::declval<const U&>().data())>::value &&
+            is_trivially_hashable<typename U::value_type>::value
+        >());
+
+    template <typename U>
+    static
+    std::false_type
+    test(
+        ...
+    );
+
+    static constexpr bool value = decltype(test<T>(0))::value;
+};
+
+// FORWARD
+// -------
+
+template <typename T>
+typename std::enable_if<hash_append_scalar<T>::value>::type
+hash_append(
+    hash_state& state,
+    const T& x
+)
+noexcept;
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value>::type
+hash_append(
+    hash_state& state,
+    const T& x
+)
+noexcept;
+
+template <typename T>
+typename std::enable_if<hash_append_trivial<T>::value>::type
+hash_append(
+    hash_state& state,
+    const T& x
+)
+noexcept;
+
+inline
+void
+hash_append(
+    hash_state& state,
+    std::nullptr_t
+)
+noexcept;
+
+template <typename C, typename Tr, typename A>
+void
+hash_append(
+    hash_state& state,
+    const std::basic_string<C, Tr, A>& x
+)
+noexcept;
+
+template <typename T1, typename T2>
+void
+hash_append(
+    hash_state& state,
+    const std::pair<T1, T2>& x
+)
+noexcept;
+
+template <typename ... Ts>
+void
+hash_append(
+    hash_state& state,
+    const std::tuple<Ts...>& x
+)
+noexcept;
+
+template <typename Range>
+typename std::enable_if<hash_append_range<Range>::value && hash_append_contiguous<Range>::value>::type
+hash_append(
+    hash_state& state,
+    const Range& x
+)
+noexcept;
+
+template <typename Range>
+typename std::enable_if<hash_append_range<Range>::value && !hash_append_contiguous<Range>::value>::type
+hash_append(
+    hash_state& state,
+    const Range& x
+)
+noexcept;
+
+// FUNCTIONS
+// ---------
+
+template <typename T>
+inline
+typename std::enable_if<hash_append_scalar<T>::value>::type
+hash_append(
+    hash_state& state,
+    const T& x
+)
+noexcept
+{
+    state.update(&x, sizeof(x));
+}
+
+
+// Equal values must hash equally, so negative zero is normalized,
+// and `long double`, which may contain padding, is narrowed.
+template <typename T>
+inline
+typename std::enable_if<std::is_floating_point<T>::value>::type
+hash_append(
+    hash_state& state,
+    const T& x
+)
+noexcept
+{
+    using value_type = typename std::conditional<std::is_same<T, long double>::value, double, T>::type;
+    value_type y = x == 0 ? value_type(0) : static_cast<value_type>(x);
+    state.update(&y, sizeof(y));
+}
+
+
+template <typename T>
+inline
+typename std::enable_if<hash_append_trivial<T>::value>::type
+hash_append(
+    hash_state& state,
+    const T& x
+)
+noexcept
+{
+    state.update(&x, sizeof(x));
+}
+
+
+inline
+void
+hash_append(
+    hash_state& state,
+    std::nullptr_t
+)
+noexcept
+{
+    hash_append(state, static_cast<void*>(nullptr));
+}
+
+
+template <typename C, typename Tr, typename A>
+inline
+void
+hash_append(
+    hash_state& state,
+    const std::basic_string<C, Tr, A>& x
+)
+noexcept
+{
+    state.update(x.data(), x.size() * sizeof(C));
+    hash_append(state, x.size());
+}
+
+
+template <typename T1, typename T2>
+inline
+void
+hash_append(
+    hash_state& state,
+    const std::pair<T1, T2>& x
+)
+noexcept
+{
+    hash_append(state, x.first);
+    hash_append(state, x.second);
+}
+
+
+template <typename Tuple, size_t ... I>
+inline
+void
+hash_append_tuple(
+    hash_state& state,
+    const Tuple& x,
+    index_sequence<I...>
+)
+noexcept
+{
+    int expand[] = {0, (hash_append(state, std::get<I>(x)), 0)...};
+    (void) expand;
+}
+
+
+template <typename ... Ts>
+inline
+void
+hash_append(
+    hash_state& state,
+    const std::tuple<Ts...>& x
+)
+noexcept
+{
+    hash_append_tuple(state, x, index_sequence_for<Ts...>());
+}
+
+
+// Produces the same bytes as appending each element, and the size.
+template <typename Range>
+inline
+typename std::enable_if<hash_append_range<Range>::value && hash_append_contiguous<Range>::value>::type
+hash_append(
+    hash_state& state,
+    const Range& x
+)
+noexcept
+{
+    using value_type = typename Range::value_type;
+    size_t size = x.size();
+    state.update(x.data(), size * sizeof(value_type));
+    hash_append(state, size);
+}
+
+
+template <typename Range>
+inline
+typename std::enable_if<hash_append_range<Range>::value && !hash_append_contiguous<Range>::value>::type
+hash_append(
+    hash_state& state,
+    const Range& x
+)
+noexcept
+{
+    // count while iterating, since `forward_list` has no `size()`
+    size_t size = 0;
+    for (const auto& value: x) {
+        hash_append(state, value);
+        ++size;
+    }
+    hash_append(state, size);
+}
+
+
+template <typename ... Ts>
+inline
+size_t
+hash_combine(
+    const Ts&... ts
+)
+noexcept
+{
+    hash_state state;
+    int expand[] = {0, (hash_append(state, ts), 0)...};
+    (void) expand;
+    return static_cast<size_t>(state.digest());
+}
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Hash any type supporting `hash_append`.
+ */
+template <typename T>
+struct hash_append_hash
+{
+    using argument_type = T;
+    using result_type = size_t;
+    using is_avalanching = std::true_type;
+
+    size_t
+    operator()(
+        const argument_type& x
+    )
+    const noexcept
+    {
+        return hash_combine(x);
+    }
+};
+
+// SPECIALIZATION
+// --------------
+
+template <typename T1, typename T2>
+struct hash<std::pair<T1, T2>>: hash_append_hash<std::pair<T1, T2>>
+{};
+
+template <typename ... Ts>
+struct hash<std::tuple<Ts...>>: hash_append_hash<std::tuple<Ts...>>
+{};
+
+template <typename ... Ts>
+struct hash<tuple<Ts...>>: hash_append_hash<tuple<Ts...>>
+{};
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,105 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Hash arrays of fixed-width keys.
+ *
+ *  `hash_batch(keys, n, out)` stores `hash<T>()(keys[i])` in `out[i]`
+ *  for each of the `n` keys, with identical results. Types hashed by
+ *  their bytes, such as trivially hashable structs and arrays up to 16
+ *  bytes, are hashed several keys at a time by `xxh3_64_batch`, which
+ *  overlaps the multiplies of independent keys and uses AVX2 for 8-byte
+ *  keys. Other types, including those with a user-provided `hash`, are
+ *  hashed one key at a time. This includes integers, enums and pointers,
+ *  such as `uint64_t` keys, since `hash` forwards them to `std::hash`,
+ *  the identity on libstdc++ and libc++: the loop is then a copy, which
+ *  is already faster than any batched mix. Hash them with `mixing_hash`
+ *  where well-mixed hashes are required.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      void hash_batch(const T* keys, size_t n, hash_result_t* out) noexcept;
+ */
+
+#pragma once
+
+#include <pycpp/stl/functional/hash.h>
+#include <pycpp/stl/functional/xxh3.h>
+#include <type_traits>
+
+PYCPP_BEGIN_NAMESPACE
+
+// HELPERS
+// -------
+
+// `hash_string` is XXH3-64 on 64-bit systems, unless `PYCPP_HASH_LEGACY`.
+#if PYCPP_SYSTEM_ARCHITECTURE == 64 && !defined(PYCPP_HASH_LEGACY)
+#   define PYCPP_HASH_BATCH_XXH3 1
+#else
+#   define PYCPP_HASH_BATCH_XXH3 0
+#endif
+
+template <typename T>
+using hash_batch_bytes = std::integral_constant<
+    bool,
+    PYCPP_HASH_BATCH_XXH3 &&
+    std::is_base_of<trivial_hash<T, true>, hash<T>>::value
+>;
+
+template <typename T>
+inline
+void
+hash_batch_impl(
+    const T* keys,
+    size_t n,
+    hash_result_t* out,
+    std::true_type
+)
+noexcept
+{
+    xxh3_64_batch(keys, sizeof(T), n, HASH_SEED, out);
+}
+
+
+template <typename T>
+inline
+void
+hash_batch_impl(
+    const T* keys,
+    size_t n,
+    hash_result_t* out,
+    std::false_type
+)
+noexcept
+{
+    hash<T> hasher;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<hash_result_t>(hasher(keys[i]));
+    }
+}
+
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief Hash `n` keys, storing `hash<T>()(keys[i])` in `out[i]`.
+ */
+template <typename T>
+inline
+void
+hash_batch(
+    const T* keys,
+    size_t n,
+    hash_result_t* out
+)
+noexcept
+{
+    hash_batch_impl(keys, n, out, hash_batch_bytes<T>());
+}
+
+// CLEANUP
+// -------
+
+#undef PYCPP_HASH_BATCH_XXH3
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,108 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#define XXH_STATIC_LINKING_ONLY
+#include <pycpp/stl/functional/hash_state.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// MACROS
+// ------
+
+#if PYCPP_SYSTEM_ARCHITECTURE <= 32
+    using xxh_state_t = XXH32_state_t;
+#   define PYCPP_XXH_RESET XXH32_reset
+#   define PYCPP_XXH_UPDATE XXH32_update
+#   define PYCPP_XXH_DIGEST XXH32_digest
+#else
+    using xxh_state_t = XXH64_state_t;
+#   define PYCPP_XXH_RESET XXH64_reset
+#   define PYCPP_XXH_UPDATE XXH64_update
+#   define PYCPP_XXH_DIGEST XXH64_digest
+#endif
+
+// OBJECTS
+// -------
+
+hash_state::hash_state()
+noexcept:
+    hash_state(HASH_SEED)
+{}
+
+
+hash_state::hash_state(
+    hash_result_t seed
+)
+noexcept:
+    seed_(seed),
+    size_(0),
+    streaming_(false)
+{
+    static_assert(sizeof(xxh_state_t) <= sizeof(state_), "xxHash state does not fit.");
+    static_assert(alignof(xxh_state_t) <= 8, "xxHash state is overaligned.");
+}
+
+
+void
+hash_state::reset()
+noexcept
+{
+    size_ = 0;
+    streaming_ = false;
+}
+
+
+void
+hash_state::reset(
+    hash_result_t seed
+)
+noexcept
+{
+    seed_ = seed;
+    reset();
+}
+
+
+void
+hash_state::flush(
+    const void* buffer,
+    size_t size
+)
+noexcept
+{
+    xxh_state_t* state = reinterpret_cast<xxh_state_t*>(state_);
+    if (!streaming_) {
+        PYCPP_XXH_RESET(state, seed_);
+        streaming_ = true;
+    }
+    PYCPP_XXH_UPDATE(state, buffer_, size_);
+    size_ = 0;
+
+    // buffer short tails, and pass long inputs through directly
+    if (size < PYCPP_HASH_STATE_BUFFER) {
+        std::memcpy(buffer_, buffer, size);
+        size_ = size;
+    } else {
+        PYCPP_XXH_UPDATE(state, buffer, size);
+    }
+}
+
+
+hash_result_t
+hash_state::digest_stream()
+const noexcept
+{
+    xxh_state_t copy;
+    std::memcpy(&copy, state_, sizeof(copy));
+    PYCPP_XXH_UPDATE(&copy, buffer_, size_);
+    return PYCPP_XXH_DIGEST(&copy);
+}
+
+// CLEANUP
+// -------
+
+#undef PYCPP_XXH_RESET
+#undef PYCPP_XXH_UPDATE
+#undef PYCPP_XXH_DIGEST
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,102 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Incremental xxHash state for hashing multiple fields.
+ *
+ *  `hash_state` hashes a sequence of byte ranges as if they were a
+ *  single buffer, so composite keys may be hashed without first
+ *  concatenating their fields. The digest is identical to `XXH64`,
+ *  or `XXH32` on 32-bit systems, of the concatenated bytes, with
+ *  `HASH_SEED` as the default seed.
+ *
+ *  Updates are copied into a small inline buffer, and keys fitting in
+ *  the buffer are hashed in a single call when digested. Only longer
+ *  inputs initialize the streaming xxHash state.
+ *
+ *  \synopsis
+ *      class hash_state
+ *      {
+ *      public:
+ *          hash_state() noexcept;
+ *          explicit hash_state(hash_result_t seed) noexcept;
+ *
+ *          void update(const void* buffer, size_t size) noexcept;
+ *          hash_result_t digest() const noexcept;
+ *          void reset() noexcept;
+ *          void reset(hash_result_t seed) noexcept;
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/stl/functional/hash.h>
+#include <cstddef>
+#include <cstring>
+
+PYCPP_BEGIN_NAMESPACE
+
+// MACROS
+// ------
+
+// Bytes buffered before initializing the streaming state.
+#ifndef PYCPP_HASH_STATE_BUFFER
+#   define PYCPP_HASH_STATE_BUFFER 64
+#endif
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Streaming hash of sequential byte ranges.
+ */
+class hash_state
+{
+public:
+    hash_state() noexcept;
+    explicit hash_state(hash_result_t seed) noexcept;
+
+    void
+    update(
+        const void* buffer,
+        size_t size
+    )
+    noexcept
+    {
+        if (size <= PYCPP_HASH_STATE_BUFFER - size_) {
+            std::memcpy(buffer_ + size_, buffer, size);
+            size_ += size;
+        } else {
+            flush(buffer, size);
+        }
+    }
+
+    hash_result_t
+    digest()
+    const noexcept
+    {
+        if (streaming_) {
+            return digest_stream();
+        }
+#if PYCPP_SYSTEM_ARCHITECTURE <= 32
+        return XXH32(buffer_, size_, seed_);
+#else
+        return XXH64(buffer_, size_, seed_);
+#endif
+    }
+
+    void reset() noexcept;
+    void reset(hash_result_t seed) noexcept;
+
+private:
+    void flush(const void* buffer, size_t size) noexcept;
+    hash_result_t digest_stream() const noexcept;
+
+    hash_result_t seed_;
+    size_t size_;
+    bool streaming_;
+    alignas(8) unsigned char state_[96];
+    unsigned char buffer_[PYCPP_HASH_STATE_BUFFER];
+};
+
+PYCPP_END_NAMESPACE
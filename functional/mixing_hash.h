@@ -0,0 +1,232 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Well-mixed hashes for integers, and detection of mixed hashes.
+ *
+ *  `hash` for integers, enums and pointers forwards to `std::hash`,
+ *  which is the identity on libstdc++ and libc++. Sequential keys then
+ *  differ only in their low bits, and cluster in open-addressing tables
+ *  with power-of-two sizes. `mixing_hash` applies the MurmurHash3
+ *  64-bit finalizer, a bijection where every input bit affects every
+ *  output bit. With a 64-bit `size_t`, distinct keys never collide.
+ *  With a 32-bit `size_t`, the high half of the result is folded into
+ *  the low half, so every input bit still affects the result, but
+ *  distinct keys wider than 32 bits may collide.
+ *
+ *  Hash functions whose every output bit depends on every input bit
+ *  declare `using is_avalanching = std::true_type;`. This covers
+ *  `mixing_hash` and the xxHash-based hashes for strings, trivially
+ *  hashable types and `hash_append`. `is_avalanching<Hash>` detects
+ *  this, so hash tables may mix the hashes of other hash functions
+ *  before reducing them to a bucket, which `mixed_hash` does.
+ *
+ *  \synopsis
+ *      uint64_t hash_mix(uint64_t x) noexcept;
+ *      size_t hash_fold(uint64_t x) noexcept;
+ *
+ *      template <typename T>
+ *      struct mixing_hash
+ *      {
+ *          using argument_type = T;
+ *          using result_type = size_t;
+ *          using is_avalanching = true_type;
+ *
+ *          size_t operator()(T x) const noexcept;
+ *      };
+ *
+ *      template <typename Hash>
+ *      struct is_avalanching;
+ *
+ *      template <typename Hash, typename T>
+ *      size_t mixed_hash(const Hash& hasher, const T& x);
+ *
+ *      #ifdef PYCPP_CPP14
+ *
+ *      template <typename Hash>
+ *      constexpr bool is_avalanching_v = implementation-defined;
+ *
+ *      #endif
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+#include <pycpp/preprocessor/compiler.h>
+#include <pycpp/stl/type_traits/has_member_type.h>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+PYCPP_BEGIN_NAMESPACE
+
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief MurmurHash3 64-bit finalizer.
+ */
+inline
+uint64_t
+hash_mix(
+    uint64_t x
+)
+noexcept
+{
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+
+/**
+ *  \brief Narrow a 64-bit hash to `size_t`, folding in the high half.
+ */
+inline
+size_t
+hash_fold(
+    uint64_t x
+)
+noexcept
+{
+    // truncating would discard the high half on 32-bit systems
+    return sizeof(size_t) < sizeof(uint64_t) ? static_cast<size_t>(x ^ (x >> 32)) : static_cast<size_t>(x);
+}
+
+// OBJECTS
+// -------
+
+// MIXING HASH
+
+template <
+    typename T,
+    bool = std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value
+>
+struct mixing_hash
+{
+    using argument_type = T;
+    using result_type = size_t;
+    using is_avalanching = std::true_type;
+
+    size_t
+    operator()(
+        T x
+    )
+    const noexcept
+    {
+        return hash_fold(hash_mix(to_integer(x)));
+    }
+
+private:
+    template <typename U>
+    static
+    typename std::enable_if<std::is_integral<U>::value, uint64_t>::type
+    to_integer(
+        U x
+    )
+    noexcept
+    {
+        return static_cast<uint64_t>(x);
+    }
+
+    template <typename U>
+    static
+    typename std::enable_if<std::is_enum<U>::value, uint64_t>::type
+    to_integer(
+        U x
+    )
+    noexcept
+    {
+        using type = typename std::underlying_type<U>::type;
+        return static_cast<uint64_t>(static_cast<type>(x));
+    }
+
+    template <typename U>
+    static
+    typename std::enable_if<std::is_pointer<U>::value, uint64_t>::type
+    to_integer(
+        U x
+    )
+    noexcept
+    {
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(x));
+    }
+};
+
+template <typename T>
+struct mixing_hash<T, false>
+{
+    mixing_hash() = delete;
+    mixing_hash(const mixing_hash&) = delete;
+    mixing_hash& operator=(const mixing_hash&) = delete;
+};
+
+// IS AVALANCHING
+
+PYCPP_HAS_MEMBER_TYPE(is_avalanching, has_is_avalanching);
+
+template <typename Hash, bool = has_is_avalanching<Hash>::value>
+struct is_avalanching: std::false_type
+{};
+
+template <typename Hash>
+struct is_avalanching<Hash, true>: std::integral_constant<bool, Hash::is_avalanching::value>
+{};
+
+#ifdef PYCPP_CPP14
+
+// SFINAE
+// ------
+
+template <typename Hash>
+constexpr bool is_avalanching_v = is_avalanching<Hash>::value;
+
+#endif
+
+// FUNCTIONS
+// ---------
+
+template <typename Hash, typename T>
+inline
+size_t
+mixed_hash_impl(
+    const Hash& hasher,
+    const T& x,
+    std::true_type
+)
+{
+    return hasher(x);
+}
+
+
+template <typename Hash, typename T>
+inline
+size_t
+mixed_hash_impl(
+    const Hash& hasher,
+    const T& x,
+    std::false_type
+)
+{
+    return hash_fold(hash_mix(static_cast<uint64_t>(hasher(x))));
+}
+
+
+/**
+ *  \brief Hash a value, mixing the result unless the hasher avalanches.
+ */
+template <typename Hash, typename T>
+inline
+size_t
+mixed_hash(
+    const Hash& hasher,
+    const T& x
+)
+{
+    return mixed_hash_impl(hasher, x, std::integral_constant<bool, is_avalanching<Hash>::value>());
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,1192 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+//
+//  XXH3 is Copyright (C) 2019-2020 Yann Collet, and licensed under
+//  the BSD 2-Clause License.
+
+#include <pycpp/preprocessor/byteorder.h>
+#include <pycpp/preprocessor/compiler.h>
+#include <pycpp/stl/functional/xxh3.h>
+#include <cstring>
+
+// MACROS
+// ------
+
+#if defined(__x86_64__) || defined(_M_X64)
+#   define PYCPP_XXH3_X86
+#endif
+
+#if !defined(PYCPP_XXH3_VECTOR)
+#   if defined(PYCPP_XXH3_X86)
+#       define PYCPP_XXH3_DISPATCH
+#       define PYCPP_XXH3_SSE2
+#       define PYCPP_XXH3_AVX2
+#   endif
+#elif PYCPP_XXH3_VECTOR == 1
+#   define PYCPP_XXH3_SSE2
+#elif PYCPP_XXH3_VECTOR == 2
+#   define PYCPP_XXH3_AVX2
+#endif
+
+#if (defined(PYCPP_XXH3_SSE2) || defined(PYCPP_XXH3_AVX2)) && !defined(PYCPP_XXH3_X86)
+#   error "SSE2 and AVX2 XXH3 require x86-64."
+#endif
+
+#if defined(PYCPP_XXH3_SSE2) || defined(PYCPP_XXH3_AVX2)
+#   include <immintrin.h>
+#endif
+
+#if defined(PYCPP_MSVC) && defined(PYCPP_XXH3_X86)
+#   include <intrin.h>
+#   pragma intrinsic(_umul128)
+#endif
+
+// MSVC allows AVX2 intrinsics in any function.
+#if defined(PYCPP_MSVC)
+#   define PYCPP_XXH3_TARGET_AVX2
+#else
+#   define PYCPP_XXH3_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+static constexpr uint64_t XXH_PRIME32_1 = 0x9E3779B1U;
+static constexpr uint64_t XXH_PRIME32_2 = 0x85EBCA77U;
+static constexpr uint64_t XXH_PRIME32_3 = 0xC2B2AE3DU;
+static constexpr uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+static constexpr uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+static constexpr uint64_t XXH_PRIME_MX1 = 0x165667919E3779F9ULL;
+static constexpr uint64_t XXH_PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+static constexpr size_t STRIPE_LEN = 64;
+static constexpr size_t SECRET_CONSUME_RATE = 8;
+static constexpr size_t ACC_NB = STRIPE_LEN / sizeof(uint64_t);
+static constexpr size_t SECRET_SIZE = sizeof(xxh3_secret);
+static constexpr size_t SECRET_SIZE_MIN = 136;
+static constexpr size_t MIDSIZE_MAX = 240;
+static constexpr size_t MIDSIZE_STARTOFFSET = 3;
+static constexpr size_t MIDSIZE_LASTOFFSET = 17;
+static constexpr size_t SECRET_LASTACC_START = 7;
+static constexpr size_t SECRET_MERGEACCS_START = 11;
+
+// HELPERS
+// -------
+
+static inline
+uint32_t
+swap32(
+    uint32_t x
+)
+noexcept
+{
+    return ((x << 24) & 0xff000000) | ((x << 8) & 0x00ff0000) | ((x >> 8) & 0x0000ff00) | ((x >> 24) & 0x000000ff);
+}
+
+
+static inline
+uint64_t
+swap64(
+    uint64_t x
+)
+noexcept
+{
+    return (static_cast<uint64_t>(swap32(static_cast<uint32_t>(x))) << 32) | swap32(static_cast<uint32_t>(x >> 32));
+}
+
+
+static inline
+uint32_t
+read_le32(
+    const uint8_t* p
+)
+noexcept
+{
+    uint32_t x;
+    std::memcpy(&x, p, sizeof(x));
+#if BYTE_ORDER == BIG_ENDIAN
+    x = swap32(x);
+#endif
+    return x;
+}
+
+
+static inline
+uint64_t
+read_le64(
+    const uint8_t* p
+)
+noexcept
+{
+    uint64_t x;
+    std::memcpy(&x, p, sizeof(x));
+#if BYTE_ORDER == BIG_ENDIAN
+    x = swap64(x);
+#endif
+    return x;
+}
+
+
+static inline
+void
+write_le64(
+    uint8_t* p,
+    uint64_t x
+)
+noexcept
+{
+#if BYTE_ORDER == BIG_ENDIAN
+    x = swap64(x);
+#endif
+    std::memcpy(p, &x, sizeof(x));
+}
+
+
+static inline
+uint32_t
+rotl32(
+    uint32_t x,
+    int r
+)
+noexcept
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+
+static inline
+uint64_t
+rotl64(
+    uint64_t x,
+    int r
+)
+noexcept
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+
+static inline
+uint64_t
+xorshift64(
+    uint64_t x,
+    int shift
+)
+noexcept
+{
+    return x ^ (x >> shift);
+}
+
+
+static inline
+xxh128_hash_t
+mult64to128(
+    uint64_t x,
+    uint64_t y
+)
+noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(x) * y;
+    return {static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64)};
+#elif defined(PYCPP_MSVC) && defined(PYCPP_XXH3_X86)
+    uint64_t high;
+    uint64_t low = _umul128(x, y, &high);
+    return {low, high};
+#else
+    // portable schoolbook multiply, in 32-bit halves
+    uint64_t lo_lo = (x & 0xFFFFFFFF) * (y & 0xFFFFFFFF);
+    uint64_t hi_lo = (x >> 32) * (y & 0xFFFFFFFF);
+    uint64_t lo_hi = (x & 0xFFFFFFFF) * (y >> 32);
+    uint64_t hi_hi = (x >> 32) * (y >> 32);
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+    return {lower, upper};
+#endif
+}
+
+
+static inline
+uint64_t
+mul128_fold64(
+    uint64_t x,
+    uint64_t y
+)
+noexcept
+{
+    xxh128_hash_t product = mult64to128(x, y);
+    return product.low64 ^ product.high64;
+}
+
+
+static inline
+uint64_t
+xxh64_avalanche(
+    uint64_t h
+)
+noexcept
+{
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+
+static inline
+uint64_t
+avalanche(
+    uint64_t h
+)
+noexcept
+{
+    h = xorshift64(h, 37);
+    h *= XXH_PRIME_MX1;
+    return xorshift64(h, 32);
+}
+
+
+static inline
+uint64_t
+rrmxmx(
+    uint64_t h,
+    uint64_t len
+)
+noexcept
+{
+    h ^= rotl64(h, 49) ^ rotl64(h, 24);
+    h *= XXH_PRIME_MX2;
+    h ^= (h >> 35) + len;
+    h *= XXH_PRIME_MX2;
+    return xorshift64(h, 28);
+}
+
+
+static inline
+uint64_t
+mix16(
+    const uint8_t* input,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    uint64_t lo = read_le64(input);
+    uint64_t hi = read_le64(input + 8);
+    return mul128_fold64(lo ^ (read_le64(secret) + seed), hi ^ (read_le64(secret + 8) - seed));
+}
+
+
+static inline
+xxh128_hash_t
+mix32(
+    xxh128_hash_t acc,
+    const uint8_t* input1,
+    const uint8_t* input2,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    acc.low64 += mix16(input1, secret, seed);
+    acc.low64 ^= read_le64(input2) + read_le64(input2 + 8);
+    acc.high64 += mix16(input2, secret + 16, seed);
+    acc.high64 ^= read_le64(input1) + read_le64(input1 + 8);
+    return acc;
+}
+
+
+static
+void
+init_secret(
+    uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    for (size_t i = 0; i < SECRET_SIZE / 16; ++i) {
+        write_le64(secret + 16 * i, read_le64(xxh3_secret + 16 * i) + seed);
+        write_le64(secret + 16 * i + 8, read_le64(xxh3_secret + 16 * i + 8) - seed);
+    }
+}
+
+// KERNELS
+// -------
+
+using accumulate_function = void (*)(uint64_t*, const uint8_t*, const uint8_t*, size_t);
+using scramble_function = void (*)(uint64_t*, const uint8_t*);
+
+struct xxh3_kernel
+{
+    accumulate_function accumulate;
+    scramble_function scramble;
+    xxh3_vector vector;
+};
+
+// SCALAR
+
+#if !defined(PYCPP_XXH3_SSE2) && !defined(PYCPP_XXH3_AVX2)
+
+static
+void
+accumulate_scalar(
+    uint64_t* acc,
+    const uint8_t* input,
+    const uint8_t* secret,
+    size_t stripes
+)
+noexcept
+{
+    // keep the accumulators in registers, since they may alias the input
+    uint64_t local[ACC_NB];
+    std::memcpy(local, acc, sizeof(local));
+    for (size_t n = 0; n < stripes; ++n) {
+        const uint8_t* in = input + n * STRIPE_LEN;
+        const uint8_t* key = secret + n * SECRET_CONSUME_RATE;
+        for (size_t i = 0; i < ACC_NB; ++i) {
+            uint64_t data = read_le64(in + 8 * i);
+            uint64_t data_key = data ^ read_le64(key + 8 * i);
+            local[i ^ 1] += data;
+            local[i] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+        }
+    }
+    std::memcpy(acc, local, sizeof(local));
+}
+
+
+static
+void
+scramble_scalar(
+    uint64_t* acc,
+    const uint8_t* secret
+)
+noexcept
+{
+    for (size_t i = 0; i < ACC_NB; ++i) {
+        uint64_t a = xorshift64(acc[i], 47);
+        a ^= read_le64(secret + 8 * i);
+        acc[i] = a * XXH_PRIME32_1;
+    }
+}
+
+#endif
+
+// SSE2
+
+#if defined(PYCPP_XXH3_SSE2)
+
+static
+void
+accumulate_sse2(
+    uint64_t* acc,
+    const uint8_t* input,
+    const uint8_t* secret,
+    size_t stripes
+)
+noexcept
+{
+    // keep the accumulators in registers, since they may alias the input
+    constexpr size_t lanes = STRIPE_LEN / sizeof(__m128i);
+    __m128i* xacc = reinterpret_cast<__m128i*>(acc);
+    __m128i local[lanes];
+    for (size_t i = 0; i < lanes; ++i) {
+        local[i] = _mm_load_si128(xacc + i);
+    }
+
+    for (size_t n = 0; n < stripes; ++n) {
+        const __m128i* xinput = reinterpret_cast<const __m128i*>(input + n * STRIPE_LEN);
+        const __m128i* xsecret = reinterpret_cast<const __m128i*>(secret + n * SECRET_CONSUME_RATE);
+        for (size_t i = 0; i < lanes; ++i) {
+            __m128i data = _mm_loadu_si128(xinput + i);
+            __m128i key = _mm_loadu_si128(xsecret + i);
+            __m128i data_key = _mm_xor_si128(data, key);
+            __m128i data_key_lo = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+            __m128i product = _mm_mul_epu32(data_key, data_key_lo);
+            __m128i data_swap = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            __m128i sum = _mm_add_epi64(local[i], data_swap);
+            local[i] = _mm_add_epi64(product, sum);
+        }
+    }
+
+    for (size_t i = 0; i < lanes; ++i) {
+        _mm_store_si128(xacc + i, local[i]);
+    }
+}
+
+
+static
+void
+scramble_sse2(
+    uint64_t* acc,
+    const uint8_t* secret
+)
+noexcept
+{
+    __m128i* xacc = reinterpret_cast<__m128i*>(acc);
+    const __m128i* xsecret = reinterpret_cast<const __m128i*>(secret);
+    const __m128i prime32 = _mm_set1_epi32(static_cast<int>(XXH_PRIME32_1));
+    for (size_t i = 0; i < STRIPE_LEN / sizeof(__m128i); ++i) {
+        __m128i a = xacc[i];
+        __m128i shifted = _mm_srli_epi64(a, 47);
+        __m128i data = _mm_xor_si128(a, shifted);
+        __m128i key = _mm_loadu_si128(xsecret + i);
+        __m128i data_key = _mm_xor_si128(data, key);
+        __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        __m128i product_lo = _mm_mul_epu32(data_key, prime32);
+        __m128i product_hi = _mm_mul_epu32(data_key_hi, prime32);
+        xacc[i] = _mm_add_epi64(product_lo, _mm_slli_epi64(product_hi, 32));
+    }
+}
+
+#endif
+
+// AVX2
+
+#if defined(PYCPP_XXH3_AVX2)
+
+PYCPP_XXH3_TARGET_AVX2
+static
+void
+accumulate_avx2(
+    uint64_t* acc,
+    const uint8_t* input,
+    const uint8_t* secret,
+    size_t stripes
+)
+noexcept
+{
+    // keep the accumulators in registers, since they may alias the input
+    constexpr size_t lanes = STRIPE_LEN / sizeof(__m256i);
+    __m256i* xacc = reinterpret_cast<__m256i*>(acc);
+    __m256i local[lanes];
+    for (size_t i = 0; i < lanes; ++i) {
+        local[i] = _mm256_loadu_si256(xacc + i);
+    }
+
+    for (size_t n = 0; n < stripes; ++n) {
+        const __m256i* xinput = reinterpret_cast<const __m256i*>(input + n * STRIPE_LEN);
+        const __m256i* xsecret = reinterpret_cast<const __m256i*>(secret + n * SECRET_CONSUME_RATE);
+        for (size_t i = 0; i < lanes; ++i) {
+            __m256i data = _mm256_loadu_si256(xinput + i);
+            __m256i key = _mm256_loadu_si256(xsecret + i);
+            __m256i data_key = _mm256_xor_si256(data, key);
+            __m256i data_key_lo = _mm256_srli_epi64(data_key, 32);
+            __m256i product = _mm256_mul_epu32(data_key, data_key_lo);
+            __m256i data_swap = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            __m256i sum = _mm256_add_epi64(local[i], data_swap);
+            local[i] = _mm256_add_epi64(product, sum);
+        }
+    }
+
+    for (size_t i = 0; i < lanes; ++i) {
+        _mm256_storeu_si256(xacc + i, local[i]);
+    }
+}
+
+
+PYCPP_XXH3_TARGET_AVX2
+static
+void
+scramble_avx2(
+    uint64_t* acc,
+    const uint8_t* secret
+)
+noexcept
+{
+    __m256i* xacc = reinterpret_cast<__m256i*>(acc);
+    const __m256i* xsecret = reinterpret_cast<const __m256i*>(secret);
+    const __m256i prime32 = _mm256_set1_epi32(static_cast<int>(XXH_PRIME32_1));
+    for (size_t i = 0; i < STRIPE_LEN / sizeof(__m256i); ++i) {
+        __m256i a = xacc[i];
+        __m256i shifted = _mm256_srli_epi64(a, 47);
+        __m256i data = _mm256_xor_si256(a, shifted);
+        __m256i key = _mm256_loadu_si256(xsecret + i);
+        __m256i data_key = _mm256_xor_si256(data, key);
+        __m256i data_key_hi = _mm256_srli_epi64(data_key, 32);
+        __m256i product_lo = _mm256_mul_epu32(data_key, prime32);
+        __m256i product_hi = _mm256_mul_epu32(data_key_hi, prime32);
+        xacc[i] = _mm256_add_epi64(product_lo, _mm256_slli_epi64(product_hi, 32));
+    }
+}
+
+#endif
+
+// DISPATCH
+
+#if defined(PYCPP_XXH3_DISPATCH)
+
+static
+bool
+has_avx2()
+noexcept
+{
+#if defined(PYCPP_MSVC)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // the OS must save the YMM registers
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+
+static
+xxh3_kernel
+select_kernel()
+noexcept
+{
+#if defined(PYCPP_XXH3_DISPATCH)
+    if (has_avx2()) {
+        return {accumulate_avx2, scramble_avx2, xxh3_vector::avx2};
+    }
+    return {accumulate_sse2, scramble_sse2, xxh3_vector::sse2};
+#elif defined(PYCPP_XXH3_AVX2)
+    return {accumulate_avx2, scramble_avx2, xxh3_vector::avx2};
+#elif defined(PYCPP_XXH3_SSE2)
+    return {accumulate_sse2, scramble_sse2, xxh3_vector::sse2};
+#else
+    return {accumulate_scalar, scramble_scalar, xxh3_vector::scalar};
+#endif
+}
+
+
+static
+const xxh3_kernel&
+kernel()
+noexcept
+{
+    static const xxh3_kernel k = select_kernel();
+    return k;
+}
+
+// SHORT INPUTS
+// ------------
+
+static inline
+uint64_t
+len_1to3_64(
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    uint32_t c1 = input[0];
+    uint32_t c2 = input[len >> 1];
+    uint32_t c3 = input[len - 1];
+    uint32_t combined = (c1 << 16) | (c2 << 24) | c3 | (static_cast<uint32_t>(len) << 8);
+    uint64_t bitflip = (read_le32(secret) ^ read_le32(secret + 4)) + seed;
+    return xxh64_avalanche(combined ^ bitflip);
+}
+
+
+static inline
+uint64_t
+len_4to8_64(
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    seed ^= static_cast<uint64_t>(swap32(static_cast<uint32_t>(seed))) << 32;
+    uint32_t input1 = read_le32(input);
+    uint32_t input2 = read_le32(input + len - 4);
+    uint64_t bitflip = (read_le64(secret + 8) ^ read_le64(secret + 16)) - seed;
+    uint64_t input64 = input2 + (static_cast<uint64_t>(input1) << 32);
+    return rrmxmx(input64 ^ bitflip, len);
+}
+
+
+static inline
+uint64_t
+len_9to16_64(
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    uint64_t bitflip1 = (read_le64(secret + 24) ^ read_le64(secret + 32)) + seed;
+    uint64_t bitflip2 = (read_le64(secret + 40) ^ read_le64(secret + 48)) - seed;
+    uint64_t lo = read_le64(input) ^ bitflip1;
+    uint64_t hi = read_le64(input + len - 8) ^ bitflip2;
+    uint64_t acc = len + swap64(lo) + hi + mul128_fold64(lo, hi);
+    return avalanche(acc);
+}
+
+
+static inline
+uint64_t
+len_0to16_64(
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    if (len > 8) {
+        return len_9to16_64(input, len, secret, seed);
+    } else if (len >= 4) {
+        return len_4to8_64(input, len, secret, seed);
+    } else if (len) {
+        return len_1to3_64(input, len, secret, seed);
+    }
+    return xxh64_avalanche(seed ^ (read_le64(secret + 56) ^ read_le64(secret + 64)));
+}
+
+
+static inline
+uint64_t
+len_17to128_64(
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    uint64_t acc = len * XXH_PRIME64_1;
+    if (len > 32) {
+        if (len > 64) {
+            if (len > 96) {
+                acc += mix16(input + 48, secret + 96, seed);
+                acc += mix16(input + len - 64, secret + 112, seed);
+            }
+            acc += mix16(input + 32, secret + 64, seed);
+            acc += mix16(input + len - 48, secret + 80, seed);
+        }
+        acc += mix16(input + 16, secret + 32, seed);
+        acc += mix16(input + len - 32, secret + 48, seed);
+    }
+    acc += mix16(input, secret, seed);
+    acc += mix16(input + len - 16, secret + 16, seed);
+
+    return avalanche(acc);
+}
+
+
+static
+uint64_t
+len_129to240_64(
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    uint64_t acc = len * XXH_PRIME64_1;
+    size_t rounds = len / 16;
+    for (size_t i = 0; i < 8; ++i) {
+        acc += mix16(input + 16 * i, secret + 16 * i, seed);
+    }
+    uint64_t acc_end = mix16(input + len - 16, secret + SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET, seed);
+    acc = avalanche(acc);
+    for (size_t i = 8; i < rounds; ++i) {
+        acc_end += mix16(input + 16 * i, secret + 16 * (i - 8) + MIDSIZE_STARTOFFSET, seed);
+    }
+
+    return avalanche(acc + acc_end);
+}
+
+
+static inline
+xxh128_hash_t
+len_1to3_128(
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    uint32_t c1 = input[0];
+    uint32_t c2 = input[len >> 1];
+    uint32_t c3 = input[len - 1];
+    uint32_t combinedl = (c1 << 16) | (c2 << 24) | c3 | (static_cast<uint32_t>(len) << 8);
+    uint32_t combinedh = rotl32(swap32(combinedl), 13);
+    uint64_t bitflipl = (read_le32(secret) ^ read_le32(secret + 4)) + seed;
+    uint64_t bitfliph = (read_le32(secret + 8) ^ read_le32(secret + 12)) - seed;
+    return {xxh64_avalanche(combinedl ^ bitflipl), xxh64_avalanche(combinedh ^ bitfliph)};
+}
+
+
+static inline
+xxh128_hash_t
+len_4to8_128(
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    seed ^= static_cast<uint64_t>(swap32(static_cast<uint32_t>(seed))) << 32;
+    uint32_t lo = read_le32(input);
+    uint32_t hi = read_le32(input + len - 4);
+    uint64_t input64 = lo + (static_cast<uint64_t>(hi) << 32);
+    uint64_t bitflip = (read_le64(secret + 16) ^ read_le64(secret + 24)) + seed;
+    uint64_t keyed = input64 ^ bitflip;
+
+    // shift len to the left to ensure it is even, avoiding even multiplies
+    xxh128_hash_t m = mult64to128(keyed, XXH_PRIME64_1 + (len << 2));
+    m.high64 += m.low64 << 1;
+    m.low64 ^= m.high64 >> 3;
+    m.low64 = xorshift64(m.low64, 35);
+    m.low64 *= XXH_PRIME_MX2;
+    m.low64 = xorshift64(m.low64, 28);
+    m.high64 = avalanche(m.high64);
+
+    return m;
+}
+
+
+static inline
+xxh128_hash_t
+len_9to16_128(
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    uint64_t bitflipl = (read_le64(secret + 32) ^ read_le64(secret + 40)) - seed;
+    uint64_t bitfliph = (read_le64(secret + 48) ^ read_le64(secret + 56)) + seed;
+    uint64_t lo = read_le64(input);
+    uint64_t hi = read_le64(input + len - 8);
+    xxh128_hash_t m = mult64to128(lo ^ hi ^ bitflipl, XXH_PRIME64_1);
+    m.low64 += static_cast<uint64_t>(len - 1) << 54;
+    hi ^= bitfliph;
+    m.high64 += hi + (hi & 0xFFFFFFFF) * (XXH_PRIME32_2 - 1);
+    m.low64 ^= swap64(m.high64);
+
+    xxh128_hash_t h = mult64to128(m.low64, XXH_PRIME64_2);
+    h.high64 += m.high64 * XXH_PRIME64_2;
+    h.low64 = avalanche(h.low64);
+    h.high64 = avalanche(h.high64);
+
+    return h;
+}
+
+
+static inline
+xxh128_hash_t
+len_0to16_128(
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    if (len > 8) {
+        return len_9to16_128(input, len, secret, seed);
+    } else if (len >= 4) {
+        return len_4to8_128(input, len, secret, seed);
+    } else if (len) {
+        return len_1to3_128(input, len, secret, seed);
+    }
+
+    uint64_t bitflipl = read_le64(secret + 64) ^ read_le64(secret + 72);
+    uint64_t bitfliph = read_le64(secret + 80) ^ read_le64(secret + 88);
+    return {xxh64_avalanche(seed ^ bitflipl), xxh64_avalanche(seed ^ bitfliph)};
+}
+
+
+static inline
+xxh128_hash_t
+finalize_128(
+    xxh128_hash_t acc,
+    size_t len,
+    uint64_t seed
+)
+noexcept
+{
+    xxh128_hash_t h;
+    h.low64 = acc.low64 + acc.high64;
+    h.high64 = (acc.low64 * XXH_PRIME64_1) + (acc.high64 * XXH_PRIME64_4) + ((len - seed) * XXH_PRIME64_2);
+    h.low64 = avalanche(h.low64);
+    h.high64 = 0 - avalanche(h.high64);
+    return h;
+}
+
+
+static inline
+xxh128_hash_t
+len_17to128_128(
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    xxh128_hash_t acc = {len * XXH_PRIME64_1, 0};
+    if (len > 32) {
+        if (len > 64) {
+            if (len > 96) {
+                acc = mix32(acc, input + 48, input + len - 64, secret + 96, seed);
+            }
+            acc = mix32(acc, input + 32, input + len - 48, secret + 64, seed);
+        }
+        acc = mix32(acc, input + 16, input + len - 32, secret + 32, seed);
+    }
+    acc = mix32(acc, input, input + len - 16, secret, seed);
+
+    return finalize_128(acc, len, seed);
+}
+
+
+static
+xxh128_hash_t
+len_129to240_128(
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret,
+    uint64_t seed
+)
+noexcept
+{
+    xxh128_hash_t acc = {len * XXH_PRIME64_1, 0};
+    for (size_t i = 32; i < 160; i += 32) {
+        acc = mix32(acc, input + i - 32, input + i - 16, secret + i - 32, seed);
+    }
+    acc.low64 = avalanche(acc.low64);
+    acc.high64 = avalanche(acc.high64);
+    for (size_t i = 160; i <= len; i += 32) {
+        acc = mix32(acc, input + i - 32, input + i - 16, secret + MIDSIZE_STARTOFFSET + i - 160, seed);
+    }
+    acc = mix32(acc, input + len - 16, input + len - 32, secret + SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET - 16, 0 - seed);
+
+    return finalize_128(acc, len, seed);
+}
+
+// LONG INPUTS
+// -----------
+
+static
+void
+hash_long(
+    uint64_t* acc,
+    const uint8_t* input,
+    size_t len,
+    const uint8_t* secret
+)
+noexcept
+{
+    const xxh3_kernel& k = kernel();
+    size_t stripes_per_block = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+    size_t block_len = STRIPE_LEN * stripes_per_block;
+    size_t blocks = (len - 1) / block_len;
+
+    for (size_t n = 0; n < blocks; ++n) {
+        k.accumulate(acc, input + n * block_len, secret, stripes_per_block);
+        k.scramble(acc, secret + SECRET_SIZE - STRIPE_LEN);
+    }
+
+    // last partial block, and the last stripe
+    size_t stripes = ((len - 1) - (block_len * blocks)) / STRIPE_LEN;
+    k.accumulate(acc, input + blocks * block_len, secret, stripes);
+    k.accumulate(acc, input + len - STRIPE_LEN, secret + SECRET_SIZE - STRIPE_LEN - SECRET_LASTACC_START, 1);
+}
+
+
+static inline
+uint64_t
+merge_accs(
+    const uint64_t* acc,
+    const uint8_t* secret,
+    uint64_t start
+)
+noexcept
+{
+    uint64_t result = start;
+    for (size_t i = 0; i < 4; ++i) {
+        result += mul128_fold64(acc[2 * i] ^ read_le64(secret + 16 * i), acc[2 * i + 1] ^ read_le64(secret + 16 * i + 8));
+    }
+    return avalanche(result);
+}
+
+
+static
+uint64_t
+hash_long_64(
+    const uint8_t* input,
+    size_t len,
+    uint64_t seed
+)
+noexcept
+{
+    alignas(64) uint64_t acc[ACC_NB] = {
+        XXH_PRIME32_3, XXH_PRIME64_1, XXH_PRIME64_2, XXH_PRIME64_3,
+        XXH_PRIME64_4, XXH_PRIME32_2, XXH_PRIME64_5, XXH_PRIME32_1
+    };
+
+    alignas(64) uint8_t custom[SECRET_SIZE];
+    const uint8_t* secret = xxh3_secret;
+    if (seed != 0) {
+        init_secret(custom, seed);
+        secret = custom;
+    }
+
+    hash_long(acc, input, len, secret);
+    return merge_accs(acc, secret + SECRET_MERGEACCS_START, len * XXH_PRIME64_1);
+}
+
+
+static
+xxh128_hash_t
+hash_long_128(
+    const uint8_t* input,
+    size_t len,
+    uint64_t seed
+)
+noexcept
+{
+    alignas(64) uint64_t acc[ACC_NB] = {
+        XXH_PRIME32_3, XXH_PRIME64_1, XXH_PRIME64_2, XXH_PRIME64_3,
+        XXH_PRIME64_4, XXH_PRIME32_2, XXH_PRIME64_5, XXH_PRIME32_1
+    };
+
+    alignas(64) uint8_t custom[SECRET_SIZE];
+    const uint8_t* secret = xxh3_secret;
+    if (seed != 0) {
+        init_secret(custom, seed);
+        secret = custom;
+    }
+
+    hash_long(acc, input, len, secret);
+    uint64_t low = merge_accs(acc, secret + SECRET_MERGEACCS_START, len * XXH_PRIME64_1);
+    uint64_t high = merge_accs(acc, secret + SECRET_SIZE - sizeof(acc) - SECRET_MERGEACCS_START, ~(len * XXH_PRIME64_2));
+    return {low, high};
+}
+
+// BATCH
+// -----
+
+// Hash keys of the same, short size. The unrolled keys are independent,
+// so their multiplies overlap, and the size is a constant, so the
+// length checks and secret reads are hoisted out of the loop.
+template <size_t Size>
+static
+void
+batch_short(
+    const uint8_t* keys,
+    size_t count,
+    uint64_t seed,
+    unsigned long long* out
+)
+noexcept
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const uint8_t* key = keys + i * Size;
+        uint64_t h0 = len_0to16_64(key, Size, xxh3_secret, seed);
+        uint64_t h1 = len_0to16_64(key + Size, Size, xxh3_secret, seed);
+        uint64_t h2 = len_0to16_64(key + 2 * Size, Size, xxh3_secret, seed);
+        uint64_t h3 = len_0to16_64(key + 3 * Size, Size, xxh3_secret, seed);
+        out[i] = h0;
+        out[i + 1] = h1;
+        out[i + 2] = h2;
+        out[i + 3] = h3;
+    }
+    for (; i < count; ++i) {
+        out[i] = len_0to16_64(keys + i * Size, Size, xxh3_secret, seed);
+    }
+}
+
+#if defined(PYCPP_XXH3_AVX2)
+
+// Low 64 bits of the product, from 32-bit multiplies, since AVX2 lacks
+// a 64-bit multiply.
+PYCPP_XXH3_TARGET_AVX2
+static inline
+__m256i
+mul64_avx2(
+    __m256i x,
+    __m256i y_lo,
+    __m256i y_hi
+)
+noexcept
+{
+    __m256i x_hi = _mm256_srli_epi64(x, 32);
+    __m256i low = _mm256_mul_epu32(x, y_lo);
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(x_hi, y_lo), _mm256_mul_epu32(x, y_hi));
+    return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+}
+
+
+PYCPP_XXH3_TARGET_AVX2
+static inline
+__m256i
+rotl64_avx2(
+    __m256i x,
+    int r
+)
+noexcept
+{
+    return _mm256_or_si256(_mm256_slli_epi64(x, r), _mm256_srli_epi64(x, 64 - r));
+}
+
+
+// `len_4to8_64` for 8-byte keys, 4 keys per vector.
+PYCPP_XXH3_TARGET_AVX2
+static
+void
+batch_8_avx2(
+    const uint8_t* keys,
+    size_t count,
+    uint64_t seed,
+    unsigned long long* out
+)
+noexcept
+{
+    uint64_t seed64 = seed ^ (static_cast<uint64_t>(swap32(static_cast<uint32_t>(seed))) << 32);
+    uint64_t flip = (read_le64(xxh3_secret + 8) ^ read_le64(xxh3_secret + 16)) - seed64;
+    const __m256i bitflip = _mm256_set1_epi64x(static_cast<long long>(flip));
+    const __m256i prime_lo = _mm256_set1_epi64x(static_cast<long long>(XXH_PRIME_MX2 & 0xFFFFFFFF));
+    const __m256i prime_hi = _mm256_set1_epi64x(static_cast<long long>(XXH_PRIME_MX2 >> 32));
+    const __m256i len = _mm256_set1_epi64x(8);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i * 8));
+        // swap the 32-bit halves, as `len_4to8_64` reads them
+        __m256i h = _mm256_xor_si256(_mm256_shuffle_epi32(data, _MM_SHUFFLE(2, 3, 0, 1)), bitflip);
+        h = _mm256_xor_si256(h, _mm256_xor_si256(rotl64_avx2(h, 49), rotl64_avx2(h, 24)));
+        h = mul64_avx2(h, prime_lo, prime_hi);
+        h = _mm256_xor_si256(h, _mm256_add_epi64(_mm256_srli_epi64(h, 35), len));
+        h = mul64_avx2(h, prime_lo, prime_hi);
+        h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 28));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), h);
+    }
+    for (; i < count; ++i) {
+        out[i] = len_4to8_64(keys + i * 8, 8, xxh3_secret, seed);
+    }
+}
+
+#endif
+
+// FUNCTIONS
+// ---------
+
+uint64_t
+xxh3_64(
+    const void* buffer,
+    size_t size,
+    uint64_t seed
+)
+noexcept
+{
+    const uint8_t* input = static_cast<const uint8_t*>(buffer);
+    if (size <= 16) {
+        return len_0to16_64(input, size, xxh3_secret, seed);
+    } else if (size <= 128) {
+        return len_17to128_64(input, size, xxh3_secret, seed);
+    } else if (size <= MIDSIZE_MAX) {
+        return len_129to240_64(input, size, xxh3_secret, seed);
+    }
+    return hash_long_64(input, size, seed);
+}
+
+
+xxh128_hash_t
+xxh3_128(
+    const void* buffer,
+    size_t size,
+    uint64_t seed
+)
+noexcept
+{
+    const uint8_t* input = static_cast<const uint8_t*>(buffer);
+    if (size <= 16) {
+        return len_0to16_128(input, size, xxh3_secret, seed);
+    } else if (size <= 128) {
+        return len_17to128_128(input, size, xxh3_secret, seed);
+    } else if (size <= MIDSIZE_MAX) {
+        return len_129to240_128(input, size, xxh3_secret, seed);
+    }
+    return hash_long_128(input, size, seed);
+}
+
+
+void
+xxh3_64_batch(
+    const void* keys,
+    size_t size,
+    size_t count,
+    uint64_t seed,
+    unsigned long long* out
+)
+noexcept
+{
+    const uint8_t* input = static_cast<const uint8_t*>(keys);
+    switch (size) {
+        case 1:  return batch_short<1>(input, count, seed, out);
+        case 2:  return batch_short<2>(input, count, seed, out);
+        case 3:  return batch_short<3>(input, count, seed, out);
+        case 4:  return batch_short<4>(input, count, seed, out);
+        case 5:  return batch_short<5>(input, count, seed, out);
+        case 6:  return batch_short<6>(input, count, seed, out);
+        case 7:  return batch_short<7>(input, count, seed, out);
+        case 8:
+#if defined(PYCPP_XXH3_DISPATCH)
+            if (kernel().vector == xxh3_vector::avx2) {
+                return batch_8_avx2(input, count, seed, out);
+            }
+#elif defined(PYCPP_XXH3_AVX2)
+            return batch_8_avx2(input, count, seed, out);
+#endif
+            return batch_short<8>(input, count, seed, out);
+        case 9:  return batch_short<9>(input, count, seed, out);
+        case 10: return batch_short<10>(input, count, seed, out);
+        case 11: return batch_short<11>(input, count, seed, out);
+        case 12: return batch_short<12>(input, count, seed, out);
+        case 13: return batch_short<13>(input, count, seed, out);
+        case 14: return batch_short<14>(input, count, seed, out);
+        case 15: return batch_short<15>(input, count, seed, out);
+        case 16: return batch_short<16>(input, count, seed, out);
+        default:
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = xxh3_64(input + i * size, size, seed);
+            }
+    }
+}
+
+
+xxh3_vector
+xxh3_dispatch()
+noexcept
+{
+    return kernel().vector;
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,167 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief XXH3 64-bit and 128-bit hash functions.
+ *
+ *  Port of the XXH3 algorithm from xxHash 0.8 [1], producing the same
+ *  hashes as the reference implementation. Inputs up to 240 bytes are
+ *  hashed with a few multiplies, several times faster than XXH64 for
+ *  short keys. Longer inputs accumulate 64-byte stripes in 8 lanes,
+ *  using scalar, SSE2 or AVX2 instructions, chosen at runtime from the
+ *  features of the CPU.
+ *
+ *  `xxh3_64_batch` hashes an array of keys of the same size, up to 16
+ *  bytes, several keys at a time, using AVX2 for 8-byte keys.
+ *
+ *  Defining `PYCPP_XXH3_VECTOR` to `0` (scalar), `1` (SSE2) or `2`
+ *  (AVX2) disables the runtime dispatch, and always uses the given
+ *  implementation. SSE2 and AVX2 are only available on x86-64.
+ *
+ *  1. https://github.com/Cyan4973/xxHash
+ *
+ *  \synopsis
+ *      constexpr uint8_t xxh3_secret[192] = implementation-defined;
+ *
+ *      struct xxh128_hash_t
+ *      {
+ *          uint64_t low64;
+ *          uint64_t high64;
+ *      };
+ *
+ *      enum class xxh3_vector
+ *      {
+ *          scalar,
+ *          sse2,
+ *          avx2,
+ *      };
+ *
+ *      bool operator==(const xxh128_hash_t& x, const xxh128_hash_t& y) noexcept;
+ *      bool operator!=(const xxh128_hash_t& x, const xxh128_hash_t& y) noexcept;
+ *
+ *      uint64_t xxh3_64(const void* buffer, size_t size, uint64_t seed = 0) noexcept;
+ *      xxh128_hash_t xxh3_128(const void* buffer, size_t size, uint64_t seed = 0) noexcept;
+ *      void xxh3_64_batch(const void* keys, size_t size, size_t count, uint64_t seed, unsigned long long* out) noexcept;
+ *      xxh3_vector xxh3_dispatch() noexcept;
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+#include <cstddef>
+#include <cstdint>
+
+PYCPP_BEGIN_NAMESPACE
+
+// CONSTANTS
+// ---------
+
+// Pseudorandom secret taken directly from FARSH.
+alignas(64) constexpr uint8_t xxh3_secret[192] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief 128-bit XXH3 hash.
+ */
+struct xxh128_hash_t
+{
+    uint64_t low64;
+    uint64_t high64;
+};
+
+/**
+ *  \brief Instruction set used for long inputs.
+ */
+enum class xxh3_vector
+{
+    scalar,
+    sse2,
+    avx2,
+};
+
+// FUNCTIONS
+// ---------
+
+inline
+bool
+operator==(
+    const xxh128_hash_t& x,
+    const xxh128_hash_t& y
+)
+noexcept
+{
+    return x.low64 == y.low64 && x.high64 == y.high64;
+}
+
+
+inline
+bool
+operator!=(
+    const xxh128_hash_t& x,
+    const xxh128_hash_t& y
+)
+noexcept
+{
+    return !(x == y);
+}
+
+/**
+ *  \brief Hash `size` bytes with XXH3-64.
+ */
+uint64_t
+xxh3_64(
+    const void* buffer,
+    size_t size,
+    uint64_t seed = 0
+)
+noexcept;
+
+/**
+ *  \brief Hash `size` bytes with XXH3-128.
+ */
+xxh128_hash_t
+xxh3_128(
+    const void* buffer,
+    size_t size,
+    uint64_t seed = 0
+)
+noexcept;
+
+/**
+ *  \brief Hash `count` keys of `size` bytes each with XXH3-64.
+ *
+ *  The output type matches `XXH64_hash_t`.
+ */
+void
+xxh3_64_batch(
+    const void* keys,
+    size_t size,
+    size_t count,
+    uint64_t seed,
+    unsigned long long* out
+)
+noexcept;
+
+/**
+ *  \brief Get the instruction set selected for long inputs.
+ */
+xxh3_vector
+xxh3_dispatch()
+noexcept;
+
+PYCPP_END_NAMESPACE
@@ -10,13 +10,22 @@
 #include <pycpp/stl/memory/allocator.h>
 #include <pycpp/stl/memory/allocator_destructor.h>
 #include <pycpp/stl/memory/allocator_traits.h>
+#include <pycpp/stl/memory/atomic_shared_ptr.h>
 #include <pycpp/stl/memory/destroy.h>
+#include <pycpp/stl/memory/epoch_reclaim.h>
+#include <pycpp/stl/memory/hazard_pointer.h>
+#include <pycpp/stl/memory/inline_arena.h>
 #include <pycpp/stl/memory/intrusive_ptr.h>
+#include <pycpp/stl/memory/intrusive_ref_counter.h>
+#include <pycpp/stl/memory/local_ref.h>
 #include <pycpp/stl/memory/make_shared.h>
 #include <pycpp/stl/memory/make_unique.h>
+#include <pycpp/stl/memory/object_pool.h>
 #include <pycpp/stl/memory/pointer_cast.h>
 #include <pycpp/stl/memory/pointer_traits.h>
 #include <pycpp/stl/memory/polymorphic_allocator.h>
+#include <pycpp/stl/memory/pool_allocator.h>
+#include <pycpp/stl/memory/rc_ptr.h>
 #include <pycpp/stl/memory/relocate.h>
 #include <pycpp/stl/memory/shared_ptr.h>
 #include <pycpp/stl/memory/swap_allocator.h>
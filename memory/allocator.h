@@ -4,28 +4,336 @@
  *  \addtogroup PySTD
  *  \brief General purpose allocator.
  *
+ *  Small requests, such as list nodes or shared pointer control blocks,
+ *  are served from lock-free, per-size free lists. Larger or over-aligned
+ *  requests use `aligned_alloc`. The allocator is stateless, and
+ *  supports `reallocate`, growing large buffers in-place when possible.
+ *
  *  \synopsis
  *      template <typename T>
- *      struct allocator;
+ *      class allocator
+ *      {
+ *      public:
+ *          using value_type = T;
+ *          using size_type = size_t;
+ *          using difference_type = ptrdiff_t;
+ *          using propagate_on_container_move_assignment = true_type;
+ *          using is_always_equal = true_type;
+ *
+ *          template <typename U>
+ *          struct rebind
+ *          {
+ *              using other = allocator<U>;
+ *          };
+ *
+ *          allocator() noexcept;
+ *          allocator(const allocator&) noexcept;
+ *          template <typename U> allocator(const allocator<U>&) noexcept;
+ *
+ *          T* allocate(size_t n);
+ *          T* allocate_zeroed(size_t n);
+ *          allocation_result<T*, size_t> allocate_at_least(size_t n);
+ *          T* reallocate(T* p, size_t old_size, size_t new_size, size_t count, size_t old_offset = 0, size_t new_offset = 0);
+ *          allocation_result<T*, size_t> reallocate_at_least(T* p, size_t old_size, size_t new_size, size_t count, size_t old_offset = 0, size_t new_offset = 0);
+ *          void deallocate(T* p, size_t n);
+ *          size_t max_size() const noexcept;
+ *      };
+ *
+ *      template <typename T1, typename T2>
+ *      bool operator==(const allocator<T1>&, const allocator<T2>&) noexcept;
+ *
+ *      template <typename T1, typename T2>
+ *      bool operator!=(const allocator<T1>&, const allocator<T2>&) noexcept;
  */
 
 #pragma once
 
+#include <pycpp/preprocessor/os.h>
+#include <pycpp/stl/cstdlib/aligned_alloc.h>
 #include <pycpp/stl/memory/allocator_traits.h>
+#include <pycpp/stl/memory/size_class.h>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
 
 PYCPP_BEGIN_NAMESPACE
 
+// HELPERS
+// -------
+
+/**
+ *  \brief Allocate `n` bytes with the given alignment.
+ */
+inline
+void*
+allocator_allocate(
+    size_t n,
+    size_t alignment
+)
+{
+    if (is_size_class(n, alignment)) {
+        return size_class_allocate(n);
+    }
+
+    // `aligned_alloc` requires a multiple of the alignment
+    size_t size = (n + alignment - 1) & ~(alignment - 1);
+    void* p = aligned_alloc(alignment, size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+/**
+ *  \brief Allocate `n` zero-initialized bytes with the given alignment.
+ */
+inline
+void*
+allocator_allocate_zeroed(
+    size_t n,
+    size_t alignment
+)
+{
+#if !defined(PYCPP_WINDOWS)
+    // `calloc` skips the memset for fresh pages, such as large, mmap'd
+    // allocations, and `aligned_free` is `free` on POSIX systems.
+    if (!is_size_class(n, alignment) && alignment <= alignof(std::max_align_t)) {
+        void* p = std::calloc(n, 1);
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+#endif
+
+    void* p = allocator_allocate(n, alignment);
+    std::memset(p, 0, n);
+    return p;
+}
+
+/**
+ *  \brief Usable size of an allocation of `n` bytes with the given alignment.
+ */
+inline
+size_t
+allocator_usable_size(
+    void* p,
+    size_t n,
+    size_t alignment
+)
+{
+    if (is_size_class(n, alignment)) {
+        return size_class_round(n);
+    }
+    return aligned_usable_size(p, alignment, n);
+}
+
+/**
+ *  \brief Deallocate `n` bytes with the given alignment.
+ */
+inline
+void
+allocator_deallocate(
+    void* p,
+    size_t n,
+    size_t alignment
+)
+noexcept
+{
+    if (is_size_class(n, alignment)) {
+        size_class_deallocate(p, n);
+    } else {
+        aligned_free(p);
+    }
+}
+
+/**
+ *  \brief Reallocate a buffer, moving `count` bytes from `old_offset` to `new_offset`.
+ */
+inline
+void*
+allocator_reallocate(
+    void* p,
+    size_t old_size,
+    size_t new_size,
+    size_t count,
+    size_t old_offset,
+    size_t new_offset,
+    size_t alignment
+)
+{
+    bool old_small = is_size_class(old_size, alignment);
+    bool new_small = is_size_class(new_size, alignment);
+    if (old_small && new_small && size_class_round(old_size) == size_class_round(new_size)) {
+        // same size class, shift the data in-place
+        char* data = static_cast<char*>(p);
+        std::memmove(data + new_offset, data + old_offset, count);
+        return p;
+    } else if (!old_small && !new_small && old_offset == 0 && new_offset == 0) {
+        // let the system grow the buffer in-place
+        size_t size = (new_size + alignment - 1) & ~(alignment - 1);
+        void* pout = aligned_realloc(p, alignment, old_size, size);
+        if (pout == nullptr) {
+            throw std::bad_alloc();
+        }
+        return pout;
+    }
+
+    void* pout = allocator_allocate(new_size, alignment);
+    std::memcpy(static_cast<char*>(pout) + new_offset, static_cast<char*>(p) + old_offset, count);
+    allocator_deallocate(p, old_size, alignment);
+    return pout;
+}
+
 // OBJECTS
 // -------
 
-// TODO: change to a specialized allocator
-// Need to make the allocator dependent on various sizes
+/**
+ *  \brief Stateless, size-class aware allocator.
+ */
 template <typename T>
-class allocator: public std::allocator<T>
+class allocator
 {
-    using std::allocator<T>::allocator;
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = allocator<U>;
+    };
+
+    // Constructors
+    allocator() noexcept = default;
+    allocator(const allocator&) noexcept = default;
+    allocator& operator=(const allocator&) noexcept = default;
+
+    template <typename U>
+    allocator(
+        const allocator<U>&
+    )
+    noexcept
+    {}
+
+    // Allocator traits
+    T*
+    allocate(
+        size_t n
+    )
+    {
+        if (n > max_size()) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(allocator_allocate(n * sizeof(T), alignof(T)));
+    }
+
+    T*
+    allocate_zeroed(
+        size_t n
+    )
+    {
+        if (n > max_size()) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(allocator_allocate_zeroed(n * sizeof(T), alignof(T)));
+    }
+
+    allocation_result<T*, size_t>
+    allocate_at_least(
+        size_t n
+    )
+    {
+        T* p = allocate(n);
+        return {p, allocator_usable_size(p, n * sizeof(T), alignof(T)) / sizeof(T)};
+    }
+
+    // Warning: Only call this for relocatable types.
+    // allocator_traits should force that behavior.
+    T*
+    reallocate(
+        T* p,
+        size_t old_size,
+        size_t new_size,
+        size_t count,
+        size_t old_offset = 0,
+        size_t new_offset = 0
+    )
+    {
+        if (new_size > max_size()) {
+            throw std::bad_alloc();
+        }
+
+        size_t old_bytes = old_size * sizeof(T);
+        size_t new_bytes = new_size * sizeof(T);
+        size_t bytes = count * sizeof(T);
+        size_t old_off = old_offset * sizeof(T);
+        size_t new_off = new_offset * sizeof(T);
+        return static_cast<T*>(allocator_reallocate(p, old_bytes, new_bytes, bytes, old_off, new_off, alignof(T)));
+    }
+
+    // Warning: Only call this for relocatable types.
+    allocation_result<T*, size_t>
+    reallocate_at_least(
+        T* p,
+        size_t old_size,
+        size_t new_size,
+        size_t count,
+        size_t old_offset = 0,
+        size_t new_offset = 0
+    )
+    {
+        T* pout = reallocate(p, old_size, new_size, count, old_offset, new_offset);
+        return {pout, allocator_usable_size(pout, new_size * sizeof(T), alignof(T)) / sizeof(T)};
+    }
+
+    void
+    deallocate(
+        T* p,
+        size_t n
+    )
+    noexcept
+    {
+        allocator_deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    size_t
+    max_size()
+    const noexcept
+    {
+        return std::numeric_limits<size_t>::max() / sizeof(T);
+    }
 };
 
+template <typename T1, typename T2>
+inline
+bool
+operator==(
+    const allocator<T1>&,
+    const allocator<T2>&
+)
+noexcept
+{
+    return true;
+}
+
+
+template <typename T1, typename T2>
+inline
+bool
+operator!=(
+    const allocator<T1>&,
+    const allocator<T2>&
+)
+noexcept
+{
+    return false;
+}
+
 // FUNCTIONS
 // ---------
 
@@ -6,6 +6,13 @@
  *  \brief Allocator traits to simplify memory allocation and construction.
  *
  *  \synopsis
+ *      template <typename Pointer, typename SizeType = size_t>
+ *      struct allocation_result
+ *      {
+ *          Pointer ptr;
+ *          SizeType count;
+ *      };
+ *
  *      template <typename Allocator>
  *      struct allocator_traits: std::allocator_traits<Allocator>
  *      {
@@ -13,6 +20,9 @@
  *          using is_always_equal = implementation-defined;
  *
  *          pointer reallocate(allocator_type& allocator, pointer ptr, size_type old_size, size_type new_size, size_type count, size_type old_offset = 0, size_type new_offset = 0);
+ *          pointer allocate_zeroed(allocator_type& allocator, size_type n);
+ *          allocation_result<pointer, size_type> allocate_at_least(allocator_type& allocator, size_type n);
+ *          allocation_result<pointer, size_type> reallocate_at_least(allocator_type& allocator, pointer ptr, size_type old_size, size_type new_size, size_type count, size_type old_offset = 0, size_type new_offset = 0);
  *
  *          template <typename Pointer>
  *          static void construct_forward(allocator_type& alloc, Pointer begin1, Pointer end1, Pointer& begin2);
@@ -29,8 +39,11 @@
 
 #include <pycpp/stl/memory/has_construct.h>
 #include <pycpp/stl/memory/to_raw_pointer.h>
+#include <pycpp/stl/type_traits/has_allocate_at_least.h>
+#include <pycpp/stl/type_traits/has_allocate_zeroed.h>
 #include <pycpp/stl/type_traits/has_is_always_equal.h>
 #include <pycpp/stl/type_traits/has_reallocate.h>
+#include <pycpp/stl/type_traits/has_reallocate_at_least.h>
 #include <pycpp/stl/type_traits/is_relocatable.h>
 #include <cassert>
 #include <cstring>
@@ -39,9 +52,34 @@
 
 PYCPP_BEGIN_NAMESPACE
 
+// HELPERS
+// -------
+
+// Lazily evaluate `Allocator::is_always_equal`, which may not exist.
+template <typename Allocator, bool = has_is_always_equal<Allocator>::value>
+struct allocator_is_always_equal
+{
+    using type = typename std::is_empty<Allocator>::type;
+};
+
+template <typename Allocator>
+struct allocator_is_always_equal<Allocator, true>
+{
+    using type = typename Allocator::is_always_equal;
+};
+
 // OBJECTS
 // -------
 
+// Allocation with the number of objects actually allocated,
+// which may exceed the requested number.
+template <typename Pointer, typename SizeType = size_t>
+struct allocation_result
+{
+    Pointer ptr;
+    SizeType count;
+};
+
 template <typename Allocator>
 struct allocator_traits: std::allocator_traits<Allocator>
 {
@@ -50,11 +88,7 @@ struct allocator_traits: std::allocator_traits<Allocator>
     using typename traits::value_type;
     using typename traits::pointer;
     using typename traits::size_type;
-    using is_always_equal = typename std::conditional<
-        has_is_always_equal<Allocator>::value,
-        typename Allocator::is_always_equal,
-        typename std::is_empty<Allocator>::type
-    >::type;
+    using is_always_equal = typename allocator_is_always_equal<Allocator>::type;
 
     // Unsafe Reallocate
     // Reallocation functions without checks for type safety.
@@ -189,6 +223,113 @@ struct allocator_traits: std::allocator_traits<Allocator>
         return reallocate_move(alloc, ptr, old_size, new_size, count, old_offset, new_offset);
     }
 
+    // Allocate zeroed
+
+    // Allocate storage for `n` objects, with every byte set to zero.
+    // Allocators may provide `allocate_zeroed` to obtain memory which
+    // is already zero, such as from `calloc` or fresh pages, avoiding
+    // the cost of writing to each byte.
+
+    // Overload if class provides specialized allocate_zeroed
+    template <typename A = allocator_type>
+    static
+    typename std::enable_if<has_allocate_zeroed<A>::value, pointer>::type
+    allocate_zeroed(
+        allocator_type& alloc,
+        size_type n
+    )
+    {
+        return alloc.allocate_zeroed(n);
+    }
+
+    // Overload if class does not provide specialized allocate_zeroed
+    template <typename A = allocator_type>
+    static
+    typename std::enable_if<!has_allocate_zeroed<A>::value, pointer>::type
+    allocate_zeroed(
+        allocator_type& alloc,
+        size_type n
+    )
+    {
+        pointer p = alloc.allocate(n);
+        std::memset(to_raw_pointer(p), 0, n * sizeof(value_type));
+        return p;
+    }
+
+    // Allocate at least
+
+    // Allocate storage for at least `n` objects, and report the
+    // capacity actually allocated, such as the usable size of a
+    // malloc'd block, so containers may use the slack.
+
+    // Overload if class provides specialized allocate_at_least
+    template <typename A = allocator_type>
+    static
+    typename std::enable_if<has_allocate_at_least<A>::value, allocation_result<pointer, size_type>>::type
+    allocate_at_least(
+        allocator_type& alloc,
+        size_type n
+    )
+    {
+        return alloc.allocate_at_least(n);
+    }
+
+    // Overload if class does not provide specialized allocate_at_least
+    template <typename A = allocator_type>
+    static
+    typename std::enable_if<!has_allocate_at_least<A>::value, allocation_result<pointer, size_type>>::type
+    allocate_at_least(
+        allocator_type& alloc,
+        size_type n
+    )
+    {
+        return {alloc.allocate(n), n};
+    }
+
+    // Reallocate at least
+
+    // Identical to `reallocate`, but report the capacity actually
+    // allocated, which may exceed `new_size`.
+
+    // Overload if class provides specialized reallocate_at_least
+    // Only use for relocatable types, like `reallocate`.
+    template <typename T = value_type, typename A = allocator_type>
+    static
+    typename std::enable_if<has_reallocate_at_least<A>::value && is_relocatable<T>::value, allocation_result<pointer, size_type>>::type
+    reallocate_at_least(
+        allocator_type& alloc,
+        pointer ptr,
+        size_type old_size,
+        size_type new_size,
+        size_type count,
+        size_type old_offset = 0,
+        size_type new_offset = 0
+    )
+    {
+        assert(count + old_offset <= old_size && "Buffer overflow.");
+        assert(count + new_offset <= new_size && "Buffer overflow.");
+
+        return alloc.reallocate_at_least(ptr, old_size, new_size, count, old_offset, new_offset);
+    }
+
+    // Overload if class does not provide specialized reallocate_at_least,
+    // or the type is not relocatable.
+    template <typename T = value_type, typename A = allocator_type>
+    static
+    typename std::enable_if<!(has_reallocate_at_least<A>::value && is_relocatable<T>::value), allocation_result<pointer, size_type>>::type
+    reallocate_at_least(
+        allocator_type& alloc,
+        pointer ptr,
+        size_type old_size,
+        size_type new_size,
+        size_type count,
+        size_type old_offset = 0,
+        size_type new_offset = 0
+    )
+    {
+        return {reallocate(alloc, ptr, old_size, new_size, count, old_offset, new_offset), new_size};
+    }
+
     // Construct forward
     template <typename Pointer>
     static
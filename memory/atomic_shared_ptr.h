@@ -0,0 +1,366 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Lock-free atomic `shared_ptr` and `weak_ptr`.
+ *
+ *  The stored value lives in a heap node, and the atomic word packs
+ *  the node address with a count of readers currently copying from it,
+ *  IE, a split reference count. Readers pin the node with a single
+ *  atomic increment, copy the value, and unpin it. Writers swap in a
+ *  new node, and transfer the outstanding pins to the old node's
+ *  internal count, so whichever thread releases the last pin frees it.
+ *  No operation takes a lock.
+ *
+ *  The address is packed into the low 48 bits of a 64-bit word on
+ *  64-bit systems, leaving 16 bits for concurrently pinned readers,
+ *  so user-space addresses must fit in 48 bits, and pointer tagging
+ *  in the upper bits is not supported. Operations synchronize with
+ *  acquire and release semantics.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      class atomic_shared_ptr
+ *      {
+ *      public:
+ *          using value_type = shared_ptr<T, true>;
+ *
+ *          constexpr atomic_shared_ptr() noexcept;
+ *          atomic_shared_ptr(value_type desired);
+ *          atomic_shared_ptr(const atomic_shared_ptr&) = delete;
+ *          atomic_shared_ptr& operator=(const atomic_shared_ptr&) = delete;
+ *          ~atomic_shared_ptr();
+ *
+ *          bool is_lock_free() const noexcept;
+ *          value_type load() const;
+ *          void store(value_type desired);
+ *          value_type exchange(value_type desired);
+ *          bool compare_exchange_weak(value_type& expected, value_type desired);
+ *          bool compare_exchange_strong(value_type& expected, value_type desired);
+ *
+ *          operator value_type() const;
+ *          void operator=(value_type desired);
+ *      };
+ *
+ *      template <typename T>
+ *      class atomic_weak_ptr
+ *      {
+ *      public:
+ *          using value_type = weak_ptr<T, true>;
+ *          // same interface as atomic_shared_ptr
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory/shared_ptr.h>
+#include <pycpp/stl/memory/weak_ptr.h>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+PYCPP_BEGIN_NAMESPACE
+
+// FUNCTIONS
+// ---------
+
+// Equivalent if both the stored pointer and ownership match.
+template <typename T, sp_mode ThreadSafe>
+inline
+bool
+sp_equivalent(
+    const shared_ptr<T, ThreadSafe>& x,
+    const shared_ptr<T, ThreadSafe>& y
+)
+noexcept
+{
+    return x.get() == y.get() && !x.owner_before(y) && !y.owner_before(x);
+}
+
+
+template <typename T, sp_mode ThreadSafe>
+inline
+bool
+sp_equivalent(
+    const weak_ptr<T, ThreadSafe>& x,
+    const weak_ptr<T, ThreadSafe>& y
+)
+noexcept
+{
+    return x.ptr_ == y.ptr_ && x.ctrl_ == y.ctrl_;
+}
+
+// OBJECTS
+// -------
+
+// ATOMIC SP BASE
+
+/**
+ *  \brief Split reference-counted atomic for shared and weak pointers.
+ */
+template <typename Pointer>
+class atomic_sp_base
+{
+public:
+    using value_type = Pointer;
+
+    constexpr
+    atomic_sp_base()
+    noexcept:
+        word_(0)
+    {}
+
+    atomic_sp_base(
+        value_type desired
+    ):
+        word_(to_word(make_node(std::move(desired))))
+    {}
+
+    atomic_sp_base(const atomic_sp_base&) = delete;
+    atomic_sp_base& operator=(const atomic_sp_base&) = delete;
+
+    ~atomic_sp_base()
+    {
+        delete to_node(word_.load(std::memory_order_relaxed));
+    }
+
+    bool
+    is_lock_free()
+    const noexcept
+    {
+        return word_.is_lock_free();
+    }
+
+    value_type
+    load()
+    const
+    {
+        node* n = pin();
+        if (n == nullptr) {
+            return value_type();
+        }
+        value_type value = n->value;
+        unpin(n);
+        return value;
+    }
+
+    void
+    store(
+        value_type desired
+    )
+    {
+        exchange(std::move(desired));
+    }
+
+    value_type
+    exchange(
+        value_type desired
+    )
+    {
+        word_type w = word_.exchange(to_word(make_node(std::move(desired))), std::memory_order_acq_rel);
+        node* n = to_node(w);
+        if (n == nullptr) {
+            return value_type();
+        }
+
+        // without pinned readers, the node is no longer shared
+        word_type pins = w >> PTR_BITS;
+        if (pins == 0) {
+            value_type value = std::move(n->value);
+            delete n;
+            return value;
+        }
+        value_type value = n->value;
+        release(n, pins);
+        return value;
+    }
+
+    bool
+    compare_exchange_weak(
+        value_type& expected,
+        value_type desired
+    )
+    {
+        return compare_exchange_strong(expected, std::move(desired));
+    }
+
+    bool
+    compare_exchange_strong(
+        value_type& expected,
+        value_type desired
+    )
+    {
+        node* nn = make_node(std::move(desired));
+        word_type desired_word = to_word(nn);
+        for (;;) {
+            node* n = pin();
+            if (n == nullptr ? !sp_equivalent(expected, value_type()) : !sp_equivalent(expected, n->value)) {
+                expected = n == nullptr ? value_type() : n->value;
+                if (n) {
+                    unpin(n);
+                }
+                delete nn;
+                return false;
+            }
+
+            // replace the node while it is current, our pin included
+            word_type w = word_.load(std::memory_order_relaxed);
+            while (to_node(w) == n) {
+                if (word_.compare_exchange_weak(w, desired_word, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    if (n) {
+                        release(n, (w >> PTR_BITS) - 1);
+                    }
+                    return true;
+                }
+            }
+
+            // replaced concurrently, retry with the new value
+            if (n) {
+                unpin(n);
+            }
+        }
+    }
+
+    operator value_type()
+    const
+    {
+        return load();
+    }
+
+    void
+    operator=(
+        value_type desired
+    )
+    {
+        store(std::move(desired));
+    }
+
+private:
+    using word_type = std::uint64_t;
+
+    struct node
+    {
+        value_type value;
+        std::atomic<long> internal;
+    };
+
+    static constexpr unsigned PTR_BITS = sizeof(void*) == 8 ? 48 : 32;
+    static constexpr word_type PTR_MASK = (static_cast<word_type>(1) << PTR_BITS) - 1;
+    static constexpr word_type PIN = static_cast<word_type>(1) << PTR_BITS;
+
+    mutable std::atomic<word_type> word_;
+
+    static
+    node*
+    make_node(
+        value_type&& value
+    )
+    {
+        if (sp_equivalent(value, value_type())) {
+            return nullptr;
+        }
+        return new node {std::move(value), {0}};
+    }
+
+    static
+    word_type
+    to_word(
+        node* n
+    )
+    noexcept
+    {
+        return static_cast<word_type>(reinterpret_cast<uintptr_t>(n));
+    }
+
+    static
+    node*
+    to_node(
+        word_type w
+    )
+    noexcept
+    {
+        return reinterpret_cast<node*>(static_cast<uintptr_t>(w & PTR_MASK));
+    }
+
+    // Pin the current node, so it cannot be freed.
+    node*
+    pin()
+    const noexcept
+    {
+        word_type w = word_.load(std::memory_order_relaxed);
+        do {
+            if (to_node(w) == nullptr) {
+                return nullptr;
+            }
+        } while (!word_.compare_exchange_weak(w, w + PIN, std::memory_order_acquire, std::memory_order_relaxed));
+
+        return to_node(w);
+    }
+
+    void
+    unpin(
+        node* n
+    )
+    const noexcept
+    {
+        // a pinned node cannot be freed, so its address cannot be reused
+        word_type w = word_.load(std::memory_order_relaxed);
+        while (to_node(w) == n) {
+            if (word_.compare_exchange_weak(w, w - PIN, std::memory_order_release, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+
+        // the node was replaced, and our pin transferred to it
+        if (n->internal.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete n;
+        }
+    }
+
+    // Transfer the pins outstanding when the node was replaced.
+    static
+    void
+    release(
+        node* n,
+        word_type pins
+    )
+    noexcept
+    {
+        long count = static_cast<long>(pins);
+        if (n->internal.fetch_add(count, std::memory_order_acq_rel) + count == 0) {
+            delete n;
+        }
+    }
+};
+
+// ATOMIC SHARED PTR
+
+/**
+ *  \brief Lock-free atomic thread-safe `shared_ptr`.
+ */
+template <typename T>
+class atomic_shared_ptr: public atomic_sp_base<shared_ptr<T, true>>
+{
+    using base = atomic_sp_base<shared_ptr<T, true>>;
+
+public:
+    using base::base;
+    using base::operator=;
+};
+
+// ATOMIC WEAK PTR
+
+/**
+ *  \brief Lock-free atomic thread-safe `weak_ptr`.
+ */
+template <typename T>
+class atomic_weak_ptr: public atomic_sp_base<weak_ptr<T, true>>
+{
+    using base = atomic_sp_base<weak_ptr<T, true>>;
+
+public:
+    using base::base;
+    using base::operator=;
+};
+
+PYCPP_END_NAMESPACE
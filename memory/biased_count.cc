@@ -0,0 +1,196 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/stl/memory/shared_count.h>
+#include <mutex>
+#include <unordered_map>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+struct sp_biased_queue_entry
+{
+    sp_biased_thread* thread;
+    sp_counted_base<SP_BIASED>* head;
+};
+
+using sp_biased_registry = std::unordered_map<uintptr_t, sp_biased_queue_entry>;
+
+// HELPERS
+// -------
+
+// The registry is leaked, so it remains valid for threads
+// exiting during static destruction.
+static
+std::mutex&
+registry_mutex()
+{
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+
+static
+sp_biased_registry&
+registry()
+{
+    static sp_biased_registry* map = new sp_biased_registry;
+    return *map;
+}
+
+
+static
+sp_counted_base<SP_BIASED>*
+take_queue(
+    uintptr_t id,
+    bool unregister
+)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    auto it = registry().find(id);
+    if (it == registry().end()) {
+        return nullptr;
+    }
+
+    sp_counted_base<SP_BIASED>* head = it->second.head;
+    it->second.head = nullptr;
+    it->second.thread->pending.store(false, std::memory_order_relaxed);
+    if (unregister) {
+        registry().erase(it);
+    }
+    return head;
+}
+
+// OBJECTS
+// -------
+
+// Unregisters the thread on exit. After the thread's ID is cleared,
+// it no longer owns any objects, so other threads may merge them.
+struct sp_biased_flusher
+{
+    ~sp_biased_flusher()
+    {
+        sp_biased_thread& thread = sp_biased_local();
+        uintptr_t id = thread.id;
+        thread.id = 0;
+        thread.dead = true;
+
+        sp_counted_base<SP_BIASED>* p = take_queue(id, true);
+        while (p) {
+            sp_counted_base<SP_BIASED>* next = p->next_queued_;
+            p->merge_queued();
+            p = next;
+        }
+    }
+};
+
+static thread_local sp_biased_flusher flusher;
+
+// FUNCTIONS
+// ---------
+
+uintptr_t
+sp_biased_register()
+{
+    sp_biased_thread& thread = sp_biased_local();
+    if (thread.dead) {
+        return SP_BIASED_NO_OWNER;
+    } else if (thread.id == 0) {
+        uintptr_t id = checked_thread_id();
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            registry().emplace(id, sp_biased_queue_entry {&thread, nullptr});
+        }
+        thread.id = id;
+        static_cast<void>(&flusher);
+    } else if (thread.pending.load(std::memory_order_relaxed)) {
+        sp_biased_merge();
+    }
+
+    return thread.id;
+}
+
+
+void
+sp_biased_queue(
+    sp_counted_base<SP_BIASED>* p,
+    uintptr_t owner
+)
+noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        auto it = registry().find(owner);
+        if (it != registry().end()) {
+            p->next_queued_ = it->second.head;
+            it->second.head = p;
+            it->second.thread->pending.store(true, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    // the owner has exited, so no thread may update the local count
+    p->merge_queued();
+}
+
+
+void
+sp_biased_merge()
+noexcept
+{
+    sp_biased_thread& thread = sp_biased_local();
+    if (thread.id == 0 || !thread.pending.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    sp_counted_base<SP_BIASED>* p = take_queue(thread.id, false);
+    while (p) {
+        sp_counted_base<SP_BIASED>* next = p->next_queued_;
+        p->merge_queued();
+        p = next;
+    }
+}
+
+// OBJECTS
+// -------
+
+void
+sp_counted_base<SP_BIASED>::merge_zero_local()
+{
+    owner_.store(SP_BIASED_NO_OWNER, std::memory_order_relaxed);
+    std::int_least32_t r = shared_.load(std::memory_order_relaxed);
+    while (!shared_.compare_exchange_weak(r, r | SP_BIASED_MERGED, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+    }
+
+    if ((r | SP_BIASED_MERGED) == SP_BIASED_MERGED) {
+        dispose();
+        weak_release();
+    }
+    sp_biased_merge();
+}
+
+
+void
+sp_counted_base<SP_BIASED>::merge_queued()
+{
+    // fold the local count into the shared count, and
+    // release the reference held by the queue.
+    std::int_least32_t local = local_.load(std::memory_order_relaxed);
+    local_.store(0, std::memory_order_relaxed);
+    owner_.store(SP_BIASED_NO_OWNER, std::memory_order_relaxed);
+
+    std::int_least32_t r = shared_.load(std::memory_order_relaxed);
+    std::int_least32_t value;
+    do {
+        value = ((r - (r & SP_BIASED_FLAGS)) + (local - 1) * SP_BIASED_ONE) | SP_BIASED_MERGED;
+    } while (!shared_.compare_exchange_weak(r, value, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    if (value == SP_BIASED_MERGED) {
+        dispose();
+        weak_release();
+    }
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,104 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Biased reference counting support for `shared_ptr`.
+ *
+ *  Shared pointers with the `SP_BIASED` mode, such as those created by
+ *  `make_shared<T, SP_BIASED>()`, bias their reference counts towards
+ *  the thread creating the object. The owning thread
+ *  updates a local count without atomic read-modify-write operations,
+ *  while other threads update a shared, atomic count. When the owner
+ *  releases its last local reference, the counts are merged, and all
+ *  further updates use the shared count.
+ *
+ *  If a non-owning thread would take the shared count below zero, the
+ *  object may only be kept alive by the owner's local count, so the
+ *  object is queued for the owner to merge, and the queue holds the
+ *  reference until then. The owner merges queued objects when it next
+ *  creates a reference-counted object, releases its last local
+ *  reference to any object, calls `sp_biased_merge()`, or exits.
+ *  Objects released from other threads may therefore be destroyed
+ *  later, on the owning thread.
+ *
+ *  Owners are identified by `checked_thread_id()`, which is never
+ *  reused, so a later thread cannot be mistaken for an exited owner.
+ *
+ *  \synopsis
+ *      void sp_biased_merge();
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory/sp_mode.h>
+#include <pycpp/stl/thread/checked_thread.h>
+#include <atomic>
+#include <cstdint>
+
+PYCPP_BEGIN_NAMESPACE
+
+// FORWARD
+// -------
+
+template <sp_mode ThreadSafe>
+class sp_counted_base;
+
+// OBJECTS
+// -------
+
+// The shared count is stored as a multiple of `SP_BIASED_ONE`,
+// with the merged and queued flags in the low bits.
+static constexpr std::int_least32_t SP_BIASED_MERGED = 1;
+static constexpr std::int_least32_t SP_BIASED_QUEUED = 2;
+static constexpr std::int_least32_t SP_BIASED_FLAGS = 3;
+static constexpr std::int_least32_t SP_BIASED_ONE = 4;
+
+// Owner of merged objects, never assigned to a thread.
+static constexpr uintptr_t SP_BIASED_NO_OWNER = ~static_cast<uintptr_t>(0);
+
+// Per-thread state. Trivial, so it remains accessible during thread
+// shutdown. The ID is the thread's `checked_thread_id()`, and is 0
+// while the thread is unregistered or exiting, when it owns nothing.
+struct sp_biased_thread
+{
+    uintptr_t id;
+    bool dead;
+    std::atomic<bool> pending;
+};
+
+// FUNCTIONS
+// ---------
+
+inline
+sp_biased_thread&
+sp_biased_local()
+noexcept
+{
+    static thread_local sp_biased_thread thread;
+    return thread;
+}
+
+/**
+ *  \brief Register the calling thread, returning the owner of new objects.
+ */
+uintptr_t
+sp_biased_register();
+
+/**
+ *  \brief Queue an object for its owner to merge.
+ */
+void
+sp_biased_queue(
+    sp_counted_base<SP_BIASED>* p,
+    uintptr_t owner
+)
+noexcept;
+
+/**
+ *  \brief Merge objects released by other threads, owned by this thread.
+ */
+void
+sp_biased_merge()
+noexcept;
+
+PYCPP_END_NAMESPACE
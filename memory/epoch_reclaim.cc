@@ -0,0 +1,157 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/stl/memory/epoch_reclaim.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+// EPOCH DOMAIN
+
+epoch_domain::epoch_domain(
+    pmr::memory_resource* r
+)
+noexcept:
+    resource_(r),
+    epoch_(0)
+{}
+
+
+epoch_domain::~epoch_domain()
+{
+    for (thread_record* r = records_.head(); r; r = r->next_record) {
+        epoch_record* record = static_cast<epoch_record*>(r);
+        for (retire_list& list: record->lists) {
+            list.reclaim();
+        }
+    }
+}
+
+
+epoch_domain&
+epoch_domain::default_domain()
+noexcept
+{
+    // leaked, so it remains valid for threads exiting during static destruction
+    static epoch_domain* domain = new epoch_domain;
+    return *domain;
+}
+
+
+pmr::memory_resource*
+epoch_domain::resource()
+const noexcept
+{
+    return resource_;
+}
+
+
+std::uint64_t
+epoch_domain::epoch()
+const noexcept
+{
+    return epoch_.load(std::memory_order_acquire);
+}
+
+
+void
+epoch_domain::retire(
+    retired_node* n
+)
+{
+    epoch_record& r = records_.local<epoch_record>();
+    std::uint64_t e = epoch_.load(std::memory_order_acquire);
+
+    // a bucket stamped with an older epoch is at least 3 epochs old
+    unsigned i = static_cast<unsigned>(e % EPOCH_BUCKETS);
+    if (r.epochs[i] != e) {
+        r.retired -= r.lists[i].size();
+        r.lists[i].reclaim();
+        r.epochs[i] = e;
+    }
+    r.lists[i].push(n);
+
+    if (++r.retired >= PYCPP_EPOCH_RECLAIM_THRESHOLD) {
+        reclaim();
+    }
+}
+
+
+void
+epoch_domain::reclaim()
+{
+    epoch_record& r = records_.local<epoch_record>();
+    std::uint64_t e = epoch_.load(std::memory_order_acquire);
+    if (try_advance(e)) {
+        ++e;
+    } else {
+        e = epoch_.load(std::memory_order_acquire);
+    }
+    collect(r, e);
+}
+
+
+bool
+epoch_domain::try_advance(
+    std::uint64_t e
+)
+noexcept
+{
+    // every thread inside a guard must have observed the current epoch
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (thread_record* r = records_.head(); r; r = r->next_record) {
+        std::uint64_t state = static_cast<epoch_record*>(r)->state.load(std::memory_order_acquire);
+        if ((state & 1) && (state >> 1) != e) {
+            return false;
+        }
+    }
+
+    return epoch_.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel, std::memory_order_relaxed);
+}
+
+
+void
+epoch_domain::collect(
+    epoch_record& r,
+    std::uint64_t e
+)
+noexcept
+{
+    for (unsigned i = 0; i < EPOCH_BUCKETS; ++i) {
+        if (!r.lists[i].empty() && r.epochs[i] + 2 <= e) {
+            r.retired -= r.lists[i].size();
+            r.lists[i].reclaim();
+        }
+    }
+}
+
+// EPOCH GUARD
+
+epoch_guard::epoch_guard():
+    epoch_guard(epoch_domain::default_domain())
+{}
+
+
+epoch_guard::epoch_guard(
+    epoch_domain& d
+):
+    record_(&d.records_.local<epoch_domain::epoch_record>())
+{
+    if (record_->nesting++ == 0) {
+        std::uint64_t e = d.epoch_.load(std::memory_order_relaxed);
+        record_->state.store((e << 1) | 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+
+epoch_guard::~epoch_guard()
+{
+    if (--record_->nesting == 0) {
+        record_->state.store(0, std::memory_order_release);
+    }
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,153 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Epoch-based reclamation for safe memory reclamation.
+ *
+ *  Readers access shared objects inside an `epoch_guard`, which
+ *  announces the global epoch the thread observed. Retired objects are
+ *  queued in a per-thread list for the epoch they were retired in, and
+ *  the global epoch only advances once every thread inside a guard
+ *  has observed it, so objects retired two epochs ago are no longer
+ *  reachable. Once a thread's lists reach a threshold, the thread
+ *  tries to advance the epoch and reclaims its expired lists in a
+ *  single batch. Retired nodes are allocated from the domain's memory
+ *  resource.
+ *
+ *  Entering and leaving a guard costs a fence and a store, compared to
+ *  a fence per protected pointer for hazard pointers, but a thread
+ *  stalled inside a guard blocks all reclamation in the domain.
+ *  Guards nest, and must be released by the thread acquiring them.
+ *
+ *  The domain must outlive its guards and the threads retiring
+ *  objects into it. Objects still retired when the domain is destroyed
+ *  are reclaimed by the destructor.
+ *
+ *  \synopsis
+ *      class epoch_domain
+ *      {
+ *      public:
+ *          explicit epoch_domain(pmr::memory_resource* r = pmr::get_default_resource()) noexcept;
+ *          epoch_domain(const epoch_domain&) = delete;
+ *          epoch_domain& operator=(const epoch_domain&) = delete;
+ *          ~epoch_domain();
+ *
+ *          static epoch_domain& default_domain() noexcept;
+ *          pmr::memory_resource* resource() const noexcept;
+ *          uint64_t epoch() const noexcept;
+ *
+ *          template <typename T, typename Deleter = default_delete<T>>
+ *          void retire(T* p, Deleter d = Deleter());
+ *          void retire(retired_node* n);
+ *          void reclaim();
+ *      };
+ *
+ *      class epoch_guard
+ *      {
+ *      public:
+ *          epoch_guard();
+ *          explicit epoch_guard(epoch_domain& d);
+ *          epoch_guard(const epoch_guard&) = delete;
+ *          epoch_guard& operator=(const epoch_guard&) = delete;
+ *          ~epoch_guard();
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory/retire_list.h>
+#include <pycpp/stl/memory/thread_record.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+PYCPP_BEGIN_NAMESPACE
+
+// MACROS
+// ------
+
+// Retired objects per thread before trying to advance the epoch.
+#ifndef PYCPP_EPOCH_RECLAIM_THRESHOLD
+#   define PYCPP_EPOCH_RECLAIM_THRESHOLD 64
+#endif
+
+// OBJECTS
+// -------
+
+// EPOCH DOMAIN
+
+/**
+ *  \brief Domain of epoch-protected readers and retired objects.
+ */
+class epoch_domain
+{
+public:
+    explicit epoch_domain(pmr::memory_resource* r = pmr::get_default_resource()) noexcept;
+    epoch_domain(const epoch_domain&) = delete;
+    epoch_domain& operator=(const epoch_domain&) = delete;
+    ~epoch_domain();
+
+    static epoch_domain& default_domain() noexcept;
+    pmr::memory_resource* resource() const noexcept;
+    std::uint64_t epoch() const noexcept;
+
+    // Reclaim `p` with `d` once no guard may observe it.
+    template <typename T, typename Deleter = std::default_delete<T>>
+    void
+    retire(
+        T* p,
+        Deleter d = Deleter()
+    )
+    {
+        retire(make_retired(resource_, p, std::move(d)));
+    }
+
+    void retire(retired_node* n);
+
+    // Try to advance the epoch, and reclaim the calling thread's
+    // expired objects.
+    void reclaim();
+
+private:
+    friend class epoch_guard;
+
+    static constexpr unsigned EPOCH_BUCKETS = 3;
+
+    // The state holds the observed epoch, shifted left by one, with
+    // the low bit set while the thread is inside a guard.
+    struct epoch_record: thread_record
+    {
+        std::atomic<std::uint64_t> state {0};
+        size_t nesting = 0;
+        size_t retired = 0;
+        retire_list lists[EPOCH_BUCKETS];
+        std::uint64_t epochs[EPOCH_BUCKETS] = {0, 0, 0};
+    };
+
+    bool try_advance(std::uint64_t e) noexcept;
+    void collect(epoch_record& r, std::uint64_t e) noexcept;
+
+    pmr::memory_resource* resource_;
+    std::atomic<std::uint64_t> epoch_;
+    thread_record_list records_;
+};
+
+// EPOCH GUARD
+
+/**
+ *  \brief RAII critical section for epoch-protected readers.
+ */
+class epoch_guard
+{
+public:
+    epoch_guard();
+    explicit epoch_guard(epoch_domain& d);
+    epoch_guard(const epoch_guard&) = delete;
+    epoch_guard& operator=(const epoch_guard&) = delete;
+    ~epoch_guard();
+
+private:
+    epoch_domain::epoch_record* record_;
+};
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,196 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/stl/memory/hazard_pointer.h>
+#include <algorithm>
+#include <vector>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+// HAZARD DOMAIN
+
+hazard_domain::hazard_domain(
+    pmr::memory_resource* r
+)
+noexcept:
+    resource_(r),
+    hazards_(nullptr),
+    hazard_count_(0)
+{}
+
+
+hazard_domain::~hazard_domain()
+{
+    for (thread_record* r = retired_.head(); r; r = r->next_record) {
+        static_cast<retire_record*>(r)->list.reclaim();
+    }
+
+    hazard_record* h = hazards_.load(std::memory_order_acquire);
+    while (h) {
+        hazard_record* next = h->next;
+        delete h;
+        h = next;
+    }
+}
+
+
+hazard_domain&
+hazard_domain::default_domain()
+noexcept
+{
+    // leaked, so it remains valid for threads exiting during static destruction
+    static hazard_domain* domain = new hazard_domain;
+    return *domain;
+}
+
+
+pmr::memory_resource*
+hazard_domain::resource()
+const noexcept
+{
+    return resource_;
+}
+
+
+void
+hazard_domain::retire(
+    retired_node* n
+)
+{
+    retire_list& list = retired_.local<retire_record>().list;
+    list.push(n);
+
+    size_t threshold = 2 * hazard_count_.load(std::memory_order_relaxed);
+    if (list.size() >= std::max<size_t>(threshold, PYCPP_HAZARD_SCAN_THRESHOLD)) {
+        scan(list);
+    }
+}
+
+
+void
+hazard_domain::reclaim()
+{
+    scan(retired_.local<retire_record>().list);
+}
+
+
+auto
+hazard_domain::acquire_record()
+    -> hazard_record*
+{
+    for (hazard_record* h = hazards_.load(std::memory_order_acquire); h; h = h->next) {
+        bool expected = false;
+        if (!h->active.load(std::memory_order_relaxed) && h->active.compare_exchange_strong(expected, true, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return h;
+        }
+    }
+
+    hazard_record* h = new hazard_record;
+    h->ptr.store(nullptr, std::memory_order_relaxed);
+    h->active.store(true, std::memory_order_relaxed);
+    hazard_record* old = hazards_.load(std::memory_order_relaxed);
+    do {
+        h->next = old;
+    } while (!hazards_.compare_exchange_weak(old, h, std::memory_order_release, std::memory_order_relaxed));
+    hazard_count_.fetch_add(1, std::memory_order_relaxed);
+
+    return h;
+}
+
+
+void
+hazard_domain::release_record(
+    hazard_record* h
+)
+noexcept
+{
+    h->ptr.store(nullptr, std::memory_order_release);
+    h->active.store(false, std::memory_order_release);
+}
+
+
+void
+hazard_domain::scan(
+    retire_list& list
+)
+{
+    // snapshot the published pointers, after the retired objects
+    // were unlinked, and reclaim every object not among them
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::vector<const void*> hazards;
+    hazards.reserve(hazard_count_.load(std::memory_order_relaxed));
+    for (hazard_record* h = hazards_.load(std::memory_order_acquire); h; h = h->next) {
+        const void* p = h->ptr.load(std::memory_order_acquire);
+        if (p) {
+            hazards.push_back(p);
+        }
+    }
+    std::sort(hazards.begin(), hazards.end());
+
+    retired_node* n = list.take();
+    while (n) {
+        retired_node* next = n->next;
+        if (std::binary_search(hazards.begin(), hazards.end(), n->ptr)) {
+            list.push(n);
+        } else {
+            n->reclaim();
+        }
+        n = next;
+    }
+}
+
+// HAZARD POINTER
+
+hazard_pointer::hazard_pointer():
+    hazard_pointer(hazard_domain::default_domain())
+{}
+
+
+hazard_pointer::hazard_pointer(
+    hazard_domain& d
+):
+    domain_(&d),
+    record_(d.acquire_record())
+{}
+
+
+hazard_pointer::hazard_pointer(
+    hazard_pointer&& other
+)
+noexcept:
+    domain_(other.domain_),
+    record_(other.record_)
+{
+    other.record_ = nullptr;
+}
+
+
+hazard_pointer&
+hazard_pointer::operator=(
+    hazard_pointer&& other
+)
+noexcept
+{
+    if (this != &other) {
+        if (record_) {
+            domain_->release_record(record_);
+        }
+        domain_ = other.domain_;
+        record_ = other.record_;
+        other.record_ = nullptr;
+    }
+    return *this;
+}
+
+
+hazard_pointer::~hazard_pointer()
+{
+    if (record_) {
+        domain_->release_record(record_);
+    }
+}
+
+PYCPP_END_NAMESPACE
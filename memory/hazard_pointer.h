@@ -0,0 +1,239 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Hazard pointers for safe memory reclamation.
+ *
+ *  A `hazard_pointer` owns a slot in a domain, which publishes the
+ *  object a reader is about to access. Retired objects are queued in
+ *  a per-thread list, and once the list reaches a threshold, scaled by
+ *  the number of slots, a batched scan snapshots all published
+ *  pointers and reclaims every retired object not among them, for an
+ *  amortized constant cost per object. Retired nodes are allocated
+ *  from the domain's memory resource.
+ *
+ *  The domain must outlive its hazard pointers and the threads
+ *  retiring objects into it. Objects still retired when the domain is
+ *  destroyed are reclaimed by the destructor, as are objects left by
+ *  exited threads, unless a new thread inherits their list first.
+ *
+ *  \synopsis
+ *      class hazard_domain
+ *      {
+ *      public:
+ *          explicit hazard_domain(pmr::memory_resource* r = pmr::get_default_resource()) noexcept;
+ *          hazard_domain(const hazard_domain&) = delete;
+ *          hazard_domain& operator=(const hazard_domain&) = delete;
+ *          ~hazard_domain();
+ *
+ *          static hazard_domain& default_domain() noexcept;
+ *          pmr::memory_resource* resource() const noexcept;
+ *
+ *          template <typename T, typename Deleter = default_delete<T>>
+ *          void retire(T* p, Deleter d = Deleter());
+ *          void retire(retired_node* n);
+ *          void reclaim();
+ *      };
+ *
+ *      class hazard_pointer
+ *      {
+ *      public:
+ *          hazard_pointer();
+ *          explicit hazard_pointer(hazard_domain& d);
+ *          hazard_pointer(hazard_pointer&&) noexcept;
+ *          hazard_pointer& operator=(hazard_pointer&&) noexcept;
+ *          ~hazard_pointer();
+ *
+ *          bool empty() const noexcept;
+ *          template <typename T> T* protect(const std::atomic<T*>& src) noexcept;
+ *          template <typename T> bool try_protect(T*& ptr, const std::atomic<T*>& src) noexcept;
+ *          template <typename T> void reset_protection(const T* p) noexcept;
+ *          void reset_protection(nullptr_t = nullptr) noexcept;
+ *          void swap(hazard_pointer& other) noexcept;
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory/retire_list.h>
+#include <pycpp/stl/memory/thread_record.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+PYCPP_BEGIN_NAMESPACE
+
+// MACROS
+// ------
+
+// Minimum retired objects per thread before a scan.
+#ifndef PYCPP_HAZARD_SCAN_THRESHOLD
+#   define PYCPP_HAZARD_SCAN_THRESHOLD 64
+#endif
+
+// OBJECTS
+// -------
+
+// HAZARD DOMAIN
+
+/**
+ *  \brief Domain of hazard pointers and retired objects.
+ */
+class hazard_domain
+{
+public:
+    explicit hazard_domain(pmr::memory_resource* r = pmr::get_default_resource()) noexcept;
+    hazard_domain(const hazard_domain&) = delete;
+    hazard_domain& operator=(const hazard_domain&) = delete;
+    ~hazard_domain();
+
+    static hazard_domain& default_domain() noexcept;
+    pmr::memory_resource* resource() const noexcept;
+
+    // Reclaim `p` with `d` once no hazard pointer protects it.
+    template <typename T, typename Deleter = std::default_delete<T>>
+    void
+    retire(
+        T* p,
+        Deleter d = Deleter()
+    )
+    {
+        retire(make_retired(resource_, p, std::move(d)));
+    }
+
+    void retire(retired_node* n);
+
+    // Scan the calling thread's retired objects.
+    void reclaim();
+
+private:
+    friend class hazard_pointer;
+
+    struct hazard_record
+    {
+        std::atomic<const void*> ptr;
+        std::atomic<bool> active;
+        hazard_record* next;
+    };
+
+    struct retire_record: thread_record
+    {
+        retire_list list;
+    };
+
+    hazard_record* acquire_record();
+    void release_record(hazard_record* r) noexcept;
+    void scan(retire_list& list);
+
+    pmr::memory_resource* resource_;
+    std::atomic<hazard_record*> hazards_;
+    std::atomic<size_t> hazard_count_;
+    thread_record_list retired_;
+};
+
+// HAZARD POINTER
+
+/**
+ *  \brief RAII owner of a hazard pointer slot.
+ */
+class hazard_pointer
+{
+public:
+    hazard_pointer();
+    explicit hazard_pointer(hazard_domain& d);
+    hazard_pointer(const hazard_pointer&) = delete;
+    hazard_pointer& operator=(const hazard_pointer&) = delete;
+    hazard_pointer(hazard_pointer&& other) noexcept;
+    hazard_pointer& operator=(hazard_pointer&& other) noexcept;
+    ~hazard_pointer();
+
+    bool
+    empty()
+    const noexcept
+    {
+        return record_ == nullptr;
+    }
+
+    // Protect the current value of `src`, retrying until it is stable.
+    template <typename T>
+    T*
+    protect(
+        const std::atomic<T*>& src
+    )
+    noexcept
+    {
+        T* p = src.load(std::memory_order_relaxed);
+        while (!try_protect(p, src)) {
+        }
+        return p;
+    }
+
+    // Protect `ptr`, if `src` still holds it, otherwise update `ptr`.
+    template <typename T>
+    bool
+    try_protect(
+        T*& ptr,
+        const std::atomic<T*>& src
+    )
+    noexcept
+    {
+        T* p = ptr;
+        reset_protection(p);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ptr = src.load(std::memory_order_acquire);
+        if (ptr != p) {
+            reset_protection();
+            return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    void
+    reset_protection(
+        const T* p
+    )
+    noexcept
+    {
+        record_->ptr.store(static_cast<const void*>(p), std::memory_order_release);
+    }
+
+    void
+    reset_protection(
+        std::nullptr_t = nullptr
+    )
+    noexcept
+    {
+        record_->ptr.store(nullptr, std::memory_order_release);
+    }
+
+    void
+    swap(
+        hazard_pointer& other
+    )
+    noexcept
+    {
+        std::swap(domain_, other.domain_);
+        std::swap(record_, other.record_);
+    }
+
+private:
+    hazard_domain* domain_;
+    hazard_domain::hazard_record* record_;
+};
+
+// FUNCTIONS
+// ---------
+
+inline
+void
+swap(
+    hazard_pointer& x,
+    hazard_pointer& y
+)
+noexcept
+{
+    x.swap(y);
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,385 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Stack-backed arena and allocator for short-lived containers.
+ *
+ *  `inline_arena<N>` bump-allocates from an inline buffer of `N` bytes,
+ *  typically on the stack. `arena_allocator` draws from the arena, and
+ *  forwards requests that do not fit to an upstream allocator. Only the
+ *  most recent allocation in the arena may be reclaimed or resized,
+ *  which allows a growing container to reallocate in-place.
+ *
+ *  The arena must outlive any container using it, and is neither
+ *  copyable nor relocatable. `vector` grows relocatable types through
+ *  `reallocate`, so while it is the most recent allocation, it extends
+ *  in-place without copying:
+ *
+ *      inline_arena<512> arena;
+ *      using alloc_type = arena_allocator<int, 512>;
+ *      vector<int, alloc_type> v(alloc_type{arena});
+ *      for (int i = 0; i < 64; ++i) {
+ *          v.push_back(i);     // never moves within the arena
+ *      }
+ *
+ *  \synopsis
+ *      template <size_t N, size_t Alignment = alignof(max_align_t)>
+ *      class inline_arena
+ *      {
+ *      public:
+ *          inline_arena() noexcept;
+ *          inline_arena(const inline_arena&) = delete;
+ *          inline_arena& operator=(const inline_arena&) = delete;
+ *
+ *          static constexpr size_t capacity() noexcept;
+ *          size_t used() const noexcept;
+ *          bool owns(const void* p) const noexcept;
+ *          void reset() noexcept;
+ *
+ *          void* allocate(size_t n, size_t alignment) noexcept;
+ *          bool resize(void* p, size_t old_size, size_t new_size) noexcept;
+ *          void deallocate(void* p, size_t n) noexcept;
+ *      };
+ *
+ *      template <typename T, size_t N, typename Upstream = allocator<T>>
+ *      class arena_allocator
+ *      {
+ *      public:
+ *          using value_type = T;
+ *          using arena_type = inline_arena<N>;
+ *          using upstream_type = Upstream;
+ *          using propagate_on_container_copy_assignment = false_type;
+ *          using propagate_on_container_move_assignment = false_type;
+ *          using propagate_on_container_swap = false_type;
+ *          using is_always_equal = false_type;
+ *
+ *          template <typename U>
+ *          struct rebind
+ *          {
+ *              using other = implementation-defined;
+ *          };
+ *
+ *          arena_allocator(arena_type& arena, const upstream_type& upstream = upstream_type()) noexcept;
+ *          arena_allocator(const arena_allocator&) noexcept;
+ *          template <typename U, typename V> arena_allocator(const arena_allocator<U, N, V>&) noexcept;
+ *
+ *          T* allocate(size_t n);
+ *          T* reallocate(T* p, size_t old_size, size_t new_size, size_t count, size_t old_offset = 0, size_t new_offset = 0);
+ *          void deallocate(T* p, size_t n);
+ *
+ *          arena_type& arena() const noexcept;
+ *          const upstream_type& upstream() const noexcept;
+ *      };
+ *
+ *      template <typename T1, typename U1, typename T2, typename U2, size_t N>
+ *      bool operator==(const arena_allocator<T1, N, U1>&, const arena_allocator<T2, N, U2>&) noexcept;
+ *
+ *      template <typename T1, typename U1, typename T2, typename U2, size_t N>
+ *      bool operator!=(const arena_allocator<T1, N, U1>&, const arena_allocator<T2, N, U2>&) noexcept;
+ */
+
+#pragma once
+
+#include <pycpp/stl/container/compressed_pair.h>
+#include <pycpp/stl/memory/allocator.h>
+#include <pycpp/stl/memory/allocator_traits.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+// INLINE ARENA
+
+/**
+ *  \brief Bump allocator over an inline buffer.
+ */
+template <size_t N, size_t Alignment = alignof(std::max_align_t)>
+class inline_arena
+{
+public:
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of 2.");
+
+    inline_arena()
+    noexcept:
+        ptr_(buf_)
+    {}
+
+    inline_arena(const inline_arena&) = delete;
+    inline_arena& operator=(const inline_arena&) = delete;
+
+    // Properties
+    static constexpr
+    size_t
+    capacity()
+    noexcept
+    {
+        return N;
+    }
+
+    size_t
+    used()
+    const noexcept
+    {
+        return static_cast<size_t>(ptr_ - buf_);
+    }
+
+    bool
+    owns(
+        const void* p
+    )
+    const noexcept
+    {
+        // compare as integers, since pointers to distinct objects are unordered
+        uintptr_t x = reinterpret_cast<uintptr_t>(p);
+        uintptr_t first = reinterpret_cast<uintptr_t>(buf_);
+        return x >= first && x < first + N;
+    }
+
+    void
+    reset()
+    noexcept
+    {
+        ptr_ = buf_;
+    }
+
+    // Allocation
+    // Returns null if the request does not fit.
+    void*
+    allocate(
+        size_t n,
+        size_t alignment
+    )
+    noexcept
+    {
+        uintptr_t p = reinterpret_cast<uintptr_t>(ptr_);
+        uintptr_t aligned = (p + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        size_t padding = static_cast<size_t>(aligned - p);
+        if (padding > remaining() || n > remaining() - padding) {
+            return nullptr;
+        }
+        ptr_ += padding + n;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Resize the most recent allocation in-place.
+    bool
+    resize(
+        void* p,
+        size_t old_size,
+        size_t new_size
+    )
+    noexcept
+    {
+        char* c = static_cast<char*>(p);
+        if (!is_tail(c, old_size) || new_size > static_cast<size_t>(buf_ + N - c)) {
+            return false;
+        }
+        ptr_ = c + new_size;
+        return true;
+    }
+
+    // Reclaims the memory only if it was the most recent allocation.
+    void
+    deallocate(
+        void* p,
+        size_t n
+    )
+    noexcept
+    {
+        char* c = static_cast<char*>(p);
+        if (is_tail(c, n)) {
+            ptr_ = c;
+        }
+    }
+
+private:
+    alignas(Alignment) char buf_[N];
+    char* ptr_;
+
+    size_t
+    remaining()
+    const noexcept
+    {
+        return static_cast<size_t>(buf_ + N - ptr_);
+    }
+
+    bool
+    is_tail(
+        char* p,
+        size_t n
+    )
+    const noexcept
+    {
+        return p + n == ptr_;
+    }
+};
+
+// ARENA ALLOCATOR
+
+/**
+ *  \brief Allocator using an inline arena, with an upstream fallback.
+ */
+template <typename T, size_t N, typename Upstream = allocator<T>>
+class arena_allocator
+{
+public:
+    using value_type = T;
+    using arena_type = inline_arena<N>;
+    using upstream_type = typename allocator_traits<Upstream>::template rebind_alloc<T>;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+    using is_always_equal = std::false_type;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = arena_allocator<U, N, typename allocator_traits<Upstream>::template rebind_alloc<U>>;
+    };
+
+    // Constructors
+    arena_allocator(const arena_allocator&) noexcept = default;
+    arena_allocator& operator=(const arena_allocator&) = delete;
+
+    arena_allocator(
+        arena_type& arena,
+        const upstream_type& upstream = upstream_type()
+    )
+    noexcept:
+        data_(&arena, upstream)
+    {}
+
+    template <typename U, typename V>
+    arena_allocator(
+        const arena_allocator<U, N, V>& rhs
+    )
+    noexcept:
+        data_(&rhs.arena(), upstream_type(rhs.upstream()))
+    {}
+
+    // Allocator traits
+    T*
+    allocate(
+        size_t n
+    )
+    {
+        if (n <= N / sizeof(T)) {
+            void* p = arena().allocate(n * sizeof(T), alignof(T));
+            if (p) {
+                return static_cast<T*>(p);
+            }
+        }
+        return upstream_traits::allocate(upstream_ref(), n);
+    }
+
+    // Warning: Only call this for relocatable types.
+    // allocator_traits should force that behavior.
+    T*
+    reallocate(
+        T* p,
+        size_t old_size,
+        size_t new_size,
+        size_t count,
+        size_t old_offset = 0,
+        size_t new_offset = 0
+    )
+    {
+        if (!arena().owns(p)) {
+            return upstream_traits::reallocate(upstream_ref(), p, old_size, new_size, count, old_offset, new_offset);
+        }
+
+        // grow or shrink the tail allocation in-place
+        if (new_size <= N / sizeof(T) && arena().resize(p, old_size * sizeof(T), new_size * sizeof(T))) {
+            if (old_offset != new_offset) {
+                std::memmove(p + new_offset, p + old_offset, count * sizeof(T));
+            }
+            return p;
+        }
+
+        T* pout = allocate(new_size);
+        std::memcpy(pout + new_offset, p + old_offset, count * sizeof(T));
+        arena().deallocate(p, old_size * sizeof(T));
+        return pout;
+    }
+
+    void
+    deallocate(
+        T* p,
+        size_t n
+    )
+    {
+        if (arena().owns(p)) {
+            arena().deallocate(p, n * sizeof(T));
+        } else {
+            upstream_traits::deallocate(upstream_ref(), p, n);
+        }
+    }
+
+    // Properties
+    arena_type&
+    arena()
+    const noexcept
+    {
+        return *data_.first();
+    }
+
+    const upstream_type&
+    upstream()
+    const noexcept
+    {
+        return data_.second();
+    }
+
+private:
+    using upstream_traits = allocator_traits<upstream_type>;
+
+    compressed_pair<arena_type*, upstream_type> data_;
+
+    upstream_type&
+    upstream_ref()
+    noexcept
+    {
+        return data_.second();
+    }
+};
+
+template <typename T1, typename U1, typename T2, typename U2, size_t N>
+inline
+bool
+operator==(
+    const arena_allocator<T1, N, U1>& x,
+    const arena_allocator<T2, N, U2>& y
+)
+noexcept
+{
+    return &x.arena() == &y.arena() && x.upstream() == y.upstream();
+}
+
+
+template <typename T1, typename U1, typename T2, typename U2, size_t N>
+inline
+bool
+operator!=(
+    const arena_allocator<T1, N, U1>& x,
+    const arena_allocator<T2, N, U2>& y
+)
+noexcept
+{
+    return !(x == y);
+}
+
+// SPECIALIZATION
+// --------------
+
+template <typename T>
+struct is_relocatable;
+
+template <typename T, size_t N, typename Upstream>
+struct is_relocatable<arena_allocator<T, N, Upstream>>: is_relocatable<Upstream>
+{};
+
+PYCPP_END_NAMESPACE
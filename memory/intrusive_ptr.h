@@ -5,8 +5,44 @@
  *  \addtogroup PySTD
  *  \brief Intrusive pointer with embedded reference counting.
  *
+ *  The default traits call `intrusive_ptr_add_ref` and
+ *  `intrusive_ptr_release`, found by argument-dependent lookup,
+ *  such as those of `intrusive_ref_counter`, if both are declared
+ *  for the type. Otherwise, the traits do not count references.
+ *
  *  \synopsis
-// TODO:
+ *      template <typename T>
+ *      struct intrusive_ptr_traits
+ *      {
+ *          using element_type = T;
+ *          static void add_ref(element_type* p);
+ *          static void release(element_type* p);
+ *      };
+ *
+ *      template <typename T, typename TraitsType = intrusive_ptr_traits<T>>
+ *      class intrusive_ptr
+ *      {
+ *      public:
+ *          using element_type = T;
+ *          using traits_type = TraitsType;
+ *
+ *          constexpr intrusive_ptr() noexcept;
+ *          intrusive_ptr(element_type* p, bool add_ref = true);
+ *          intrusive_ptr(const intrusive_ptr& x);
+ *          intrusive_ptr(intrusive_ptr&& x);
+ *          ~intrusive_ptr();
+ *
+ *          element_type* get() const noexcept;
+ *          element_type& operator*() const noexcept;
+ *          element_type* operator->() const noexcept;
+ *          explicit operator bool() const noexcept;
+ *
+ *          void reset();
+ *          void reset(element_type* x);
+ *          void reset(element_type* x, bool add_ref);
+ *          element_type* release() noexcept;
+ *          void swap(intrusive_ptr& x) noexcept;
+ *      };
  */
 
 #pragma once
@@ -17,6 +53,7 @@
 #include <cstddef>
 #include <functional>
 #include <type_traits>
+#include <utility>
 
 PYCPP_BEGIN_NAMESPACE
 
@@ -32,7 +69,7 @@ PYCPP_BEGIN_NAMESPACE
 // This class will be compressed, so unless reference
 // counting is required in the class, it will
 // not increase the class size.
-template <typename T>
+template <typename T, typename = void>
 struct intrusive_ptr_traits
 {
     using element_type = T;
@@ -52,6 +89,36 @@ struct intrusive_ptr_traits
     {}
 };
 
+// Traits for types declaring `intrusive_ptr_add_ref` and
+// `intrusive_ptr_release`, like `intrusive_ref_counter`.
+template <typename T>
+struct intrusive_ptr_traits<T, decltype(
+    intrusive_ptr_add_ref(std::declval<T*>()),
+    intrusive_ptr_release(std::declval<T*>()),
+    void()
+)>
+{
+    using element_type = T;
+
+    static
+    void
+    add_ref(
+        element_type* p
+    )
+    {
+        intrusive_ptr_add_ref(p);
+    }
+
+    static
+    void
+    release(
+        element_type* p
+    )
+    {
+        intrusive_ptr_release(p);
+    }
+};
+
 // INTRUSIVE PTR
 
 template <typename T, typename TraitsType = intrusive_ptr_traits<T>>
@@ -162,7 +229,7 @@ public:
     )
     noexcept
     {
-        intrusive_ptr(move(x)).swap(*this);
+        intrusive_ptr(std::move(x)).swap(*this);
         return *this;
     }
 
@@ -172,7 +239,7 @@ public:
     )
     noexcept
     {
-        intrusive_ptr(move(x)).swap(*this);
+        intrusive_ptr(std::move(x)).swap(*this);
         return *this;
     }
 
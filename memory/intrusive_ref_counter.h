@@ -0,0 +1,295 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Reference counter base for `intrusive_ptr`.
+ *
+ *  `intrusive_ref_counter` embeds the reference count in the object,
+ *  so an `intrusive_ptr` needs neither a separate control block nor
+ *  an indirection to reach it. Like `shared_ptr`, the thread-safe
+ *  counter uses atomic operations, while the single-threaded counter
+ *  uses plain arithmetic, and aborts in debug builds if used from
+ *  another thread. `intrusive_ptr` finds the counter through
+ *  `intrusive_ptr_add_ref` and `intrusive_ptr_release`, so no custom
+ *  traits are required.
+ *
+ *  When the last reference is released, the object is passed to the
+ *  `Deleter`. `intrusive_pool_delete` returns the object's memory to
+ *  `allocator<T>`, which keeps small blocks in per-thread free lists,
+ *  so objects from `make_pooled_intrusive` are recycled without
+ *  touching the heap.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      struct intrusive_delete
+ *      {
+ *          void operator()(const T* p) const noexcept;
+ *      };
+ *
+ *      template <typename T>
+ *      struct intrusive_pool_delete
+ *      {
+ *          void operator()(const T* p) const noexcept;
+ *      };
+ *
+ *      template <typename Derived, bool ThreadSafe = true, typename Deleter = intrusive_delete<Derived>>
+ *      class intrusive_ref_counter
+ *      {
+ *      public:
+ *          using deleter_type = Deleter;
+ *          static constexpr bool thread_safe = ThreadSafe;
+ *
+ *          intrusive_ref_counter() noexcept;
+ *          intrusive_ref_counter(const intrusive_ref_counter&) noexcept;
+ *          intrusive_ref_counter& operator=(const intrusive_ref_counter&) noexcept;
+ *          long use_count() const noexcept;
+ *
+ *      protected:
+ *          ~intrusive_ref_counter() = default;
+ *      };
+ *
+ *      template <typename T, typename ... Ts>
+ *      intrusive_ptr<T> make_intrusive(Ts&&... ts);
+ *
+ *      template <typename T, typename ... Ts>
+ *      intrusive_ptr<T> make_pooled_intrusive(Ts&&... ts);
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory/allocator.h>
+#include <pycpp/stl/memory/intrusive_ptr.h>
+#include <pycpp/stl/memory/shared_count.h>
+#include <new>
+#include <utility>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+// INTRUSIVE DELETE
+
+template <typename T>
+struct intrusive_delete
+{
+    void
+    operator()(
+        const T* p
+    )
+    const noexcept
+    {
+        delete p;
+    }
+};
+
+// INTRUSIVE POOL DELETE
+
+template <typename T>
+struct intrusive_pool_delete
+{
+    void
+    operator()(
+        const T* p
+    )
+    const noexcept
+    {
+        T* q = const_cast<T*>(p);
+        q->~T();
+        allocator<T>().deallocate(q, 1);
+    }
+};
+
+// INTRUSIVE REF COUNT
+
+template <bool ThreadSafe>
+class intrusive_ref_count;
+
+// Thread-safe
+template <>
+class intrusive_ref_count<true>
+{
+public:
+    explicit
+    intrusive_ref_count(
+        std::int_least32_t count = 0
+    )
+    noexcept:
+        count_(count)
+    {}
+
+    void
+    increment()
+    noexcept
+    {
+        atomic_increment(&count_);
+    }
+
+    // Returns true if the last reference was released.
+    bool
+    decrement()
+    noexcept
+    {
+        return atomic_decrement(&count_) == 1;
+    }
+
+    long
+    load()
+    const noexcept
+    {
+        return count_.load(std::memory_order_acquire);
+    }
+
+private:
+    std::atomic_int_least32_t count_;
+};
+
+// Single-threaded
+template <>
+class intrusive_ref_count<false>: checked_thread<false>
+{
+public:
+    explicit
+    intrusive_ref_count(
+        std::int_least32_t count = 0
+    )
+    noexcept:
+        count_(count)
+    {}
+
+    void
+    increment()
+    noexcept
+    {
+        this->check();
+        ++count_;
+    }
+
+    bool
+    decrement()
+    noexcept
+    {
+        this->check();
+        return --count_ == 0;
+    }
+
+    long
+    load()
+    const noexcept
+    {
+        this->check();
+        return count_;
+    }
+
+private:
+    std::int_least32_t count_;
+};
+
+// INTRUSIVE REF COUNTER
+
+template <
+    typename Derived,
+    bool ThreadSafe = PYCPP_SP_THREAD_SAFE,
+    typename Deleter = intrusive_delete<Derived>
+>
+class intrusive_ref_counter
+{
+public:
+    using deleter_type = Deleter;
+    static constexpr bool thread_safe = ThreadSafe;
+
+    intrusive_ref_counter()
+    noexcept
+    {}
+
+    // The count belongs to the object, and is never copied.
+    intrusive_ref_counter(
+        const intrusive_ref_counter&
+    )
+    noexcept
+    {}
+
+    intrusive_ref_counter&
+    operator=(
+        const intrusive_ref_counter&
+    )
+    noexcept
+    {
+        return *this;
+    }
+
+    long
+    use_count()
+    const noexcept
+    {
+        return count_.load();
+    }
+
+protected:
+    ~intrusive_ref_counter() = default;
+
+private:
+    mutable intrusive_ref_count<ThreadSafe> count_;
+
+    friend
+    void
+    intrusive_ptr_add_ref(
+        const intrusive_ref_counter* p
+    )
+    noexcept
+    {
+        p->count_.increment();
+    }
+
+    friend
+    void
+    intrusive_ptr_release(
+        const intrusive_ref_counter* p
+    )
+    noexcept
+    {
+        if (p->count_.decrement()) {
+            Deleter()(static_cast<const Derived*>(p));
+        }
+    }
+};
+
+// FUNCTIONS
+// ---------
+
+template <typename T, typename ... Ts>
+inline
+intrusive_ptr<T>
+make_intrusive(
+    Ts&&... ts
+)
+{
+    return intrusive_ptr<T>(new T(std::forward<Ts>(ts)...));
+}
+
+
+template <typename T, typename ... Ts>
+inline
+intrusive_ptr<T>
+make_pooled_intrusive(
+    Ts&&... ts
+)
+{
+    static_assert(
+        std::is_same<typename T::deleter_type, intrusive_pool_delete<T>>::value,
+        "Pooled objects must be released with intrusive_pool_delete."
+    );
+
+    allocator<T> alloc;
+    T* p = alloc.allocate(1);
+    try {
+        ::new (static_cast<void*>(p)) T(std::forward<Ts>(ts)...);
+    } catch (...) {
+        alloc.deallocate(p, 1);
+        throw;
+    }
+
+    return intrusive_ptr<T>(p);
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,344 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Thread-local references batched onto a single `shared_ptr`.
+ *
+ *  Every copy of a thread-safe `shared_ptr` updates the shared use
+ *  count, so many threads copying and releasing the same object
+ *  contend on a single cache line. A `local_ref` takes one strong
+ *  reference from a `shared_ptr`, and its copies share a plain,
+ *  single-threaded count instead. The strong reference is released,
+ *  in a single atomic operation, once the last copy is destroyed.
+ *
+ *  All copies of a `local_ref` must be used from the thread that
+ *  created it, which aborts in debug builds otherwise. Threads should
+ *  each take their own `local_ref`, from a `shared_ptr` or from
+ *  `shared()`, to hand out references within the thread.
+ *
+ *  \synopsis
+ *      template <typename T, sp_mode ThreadSafe = true>
+ *      class local_ref
+ *      {
+ *      public:
+ *          using element_type = T;
+ *          using shared_type = shared_ptr<T, ThreadSafe>;
+ *
+ *          constexpr local_ref() noexcept;
+ *          constexpr local_ref(nullptr_t) noexcept;
+ *          explicit local_ref(const shared_type& p);
+ *          explicit local_ref(shared_type&& p);
+ *          local_ref(const local_ref& r) noexcept;
+ *          local_ref(local_ref&& r) noexcept;
+ *          ~local_ref();
+ *
+ *          local_ref& operator=(const local_ref& r) noexcept;
+ *          local_ref& operator=(local_ref&& r) noexcept;
+ *          local_ref& operator=(nullptr_t) noexcept;
+ *
+ *          void reset() noexcept;
+ *          void swap(local_ref& r) noexcept;
+ *
+ *          element_type* get() const noexcept;
+ *          element_type& operator*() const noexcept;
+ *          element_type* operator->() const noexcept;
+ *          long local_count() const noexcept;
+ *          shared_type shared() const;
+ *          explicit operator bool() const noexcept;
+ *      };
+ *
+ *      template <typename T, sp_mode ThreadSafe>
+ *      local_ref<T, ThreadSafe> make_local_ref(const shared_ptr<T, ThreadSafe>& p);
+ *
+ *      template <typename T, sp_mode ThreadSafe>
+ *      local_ref<T, ThreadSafe> make_local_ref(shared_ptr<T, ThreadSafe>&& p);
+ *
+ *      template <typename T, sp_mode ThreadSafe>
+ *      void swap(local_ref<T, ThreadSafe>& x, local_ref<T, ThreadSafe>& y) noexcept;
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory/allocator.h>
+#include <pycpp/stl/memory/intrusive_ref_counter.h>
+#include <pycpp/stl/memory/shared_ptr.h>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+// LOCAL REF BLOCK
+
+template <typename T, sp_mode ThreadSafe>
+struct local_ref_block
+{
+    template <typename Ptr>
+    explicit
+    local_ref_block(
+        Ptr&& p
+    ):
+        count(1),
+        owner(std::forward<Ptr>(p))
+    {}
+
+    intrusive_ref_count<false> count;
+    shared_ptr<T, ThreadSafe> owner;
+};
+
+// LOCAL REF
+
+template <typename T, sp_mode ThreadSafe = PYCPP_SP_THREAD_SAFE>
+class local_ref
+{
+    static_assert(!std::is_array<T>::value, "local_ref does not support arrays.");
+
+    using block_type = local_ref_block<T, ThreadSafe>;
+    using allocator_type = allocator<block_type>;
+
+public:
+    using element_type = T;
+    using shared_type = shared_ptr<T, ThreadSafe>;
+
+    // CONSTRUCTORS
+
+    constexpr
+    local_ref()
+    noexcept:
+        ptr_(nullptr),
+        block_(nullptr)
+    {}
+
+    constexpr
+    local_ref(
+        std::nullptr_t
+    )
+    noexcept:
+        ptr_(nullptr),
+        block_(nullptr)
+    {}
+
+    explicit
+    local_ref(
+        const shared_type& p
+    ):
+        ptr_(p.get()),
+        block_(create(p))
+    {}
+
+    explicit
+    local_ref(
+        shared_type&& p
+    ):
+        ptr_(p.get()),
+        block_(create(std::move(p)))
+    {}
+
+    local_ref(
+        const local_ref& r
+    )
+    noexcept:
+        ptr_(r.ptr_),
+        block_(r.block_)
+    {
+        if (block_) {
+            block_->count.increment();
+        }
+    }
+
+    local_ref(
+        local_ref&& r
+    )
+    noexcept:
+        ptr_(r.ptr_),
+        block_(r.block_)
+    {
+        r.ptr_ = nullptr;
+        r.block_ = nullptr;
+    }
+
+    ~local_ref()
+    {
+        release(block_);
+    }
+
+    // ASSIGNMENT
+
+    local_ref&
+    operator=(
+        const local_ref& r
+    )
+    noexcept
+    {
+        local_ref(r).swap(*this);
+        return *this;
+    }
+
+    local_ref&
+    operator=(
+        local_ref&& r
+    )
+    noexcept
+    {
+        local_ref(std::move(r)).swap(*this);
+        return *this;
+    }
+
+    local_ref&
+    operator=(
+        std::nullptr_t
+    )
+    noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    // MODIFIERS
+
+    void
+    reset()
+    noexcept
+    {
+        block_type* b = block_;
+        ptr_ = nullptr;
+        block_ = nullptr;
+        release(b);
+    }
+
+    void
+    swap(
+        local_ref& r
+    )
+    noexcept
+    {
+        std::swap(ptr_, r.ptr_);
+        std::swap(block_, r.block_);
+    }
+
+    // OBSERVERS
+
+    element_type*
+    get()
+    const noexcept
+    {
+        return ptr_;
+    }
+
+    element_type&
+    operator*()
+    const noexcept
+    {
+        assert(ptr_ != nullptr);
+        return *ptr_;
+    }
+
+    element_type*
+    operator->()
+    const noexcept
+    {
+        assert(ptr_ != nullptr);
+        return ptr_;
+    }
+
+    // Number of local references sharing the strong reference.
+    long
+    local_count()
+    const noexcept
+    {
+        return block_ ? block_->count.load() : 0;
+    }
+
+    // Take a new strong reference, which may be passed to other threads.
+    shared_type
+    shared()
+    const
+    {
+        return block_ ? block_->owner : shared_type();
+    }
+
+    explicit
+    operator bool()
+    const noexcept
+    {
+        return ptr_ != nullptr;
+    }
+
+private:
+    template <typename Ptr>
+    static
+    block_type*
+    create(
+        Ptr&& p
+    )
+    {
+        if (!p) {
+            return nullptr;
+        }
+
+        allocator_type alloc;
+        block_type* b = alloc.allocate(1);
+        ::new (static_cast<void*>(b)) block_type(std::forward<Ptr>(p));
+        return b;
+    }
+
+    static
+    void
+    release(
+        block_type* b
+    )
+    noexcept
+    {
+        if (b && b->count.decrement()) {
+            b->~block_type();
+            allocator_type().deallocate(b, 1);
+        }
+    }
+
+    element_type* ptr_;
+    block_type* block_;
+};
+
+// FUNCTIONS
+// ---------
+
+template <typename T, sp_mode ThreadSafe>
+inline
+local_ref<T, ThreadSafe>
+make_local_ref(
+    const shared_ptr<T, ThreadSafe>& p
+)
+{
+    return local_ref<T, ThreadSafe>(p);
+}
+
+
+template <typename T, sp_mode ThreadSafe>
+inline
+local_ref<T, ThreadSafe>
+make_local_ref(
+    shared_ptr<T, ThreadSafe>&& p
+)
+{
+    return local_ref<T, ThreadSafe>(std::move(p));
+}
+
+
+template <typename T, sp_mode ThreadSafe>
+inline
+void
+swap(
+    local_ref<T, ThreadSafe>& x,
+    local_ref<T, ThreadSafe>& y
+)
+noexcept
+{
+    x.swap(y);
+}
+
+PYCPP_END_NAMESPACE
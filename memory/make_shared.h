@@ -5,207 +5,365 @@
  *  \addtogroup PySTD
  *  \brief `make_shared` utility functions.
  *
- *  Deleters for the shared_ptr helpers `make_shared` and
- *  `allocate_shared`.
+ *  Control blocks for the shared_ptr helpers `make_shared` and
+ *  `allocate_shared`, which store the object, or the array elements,
+ *  after the reference counts, in a single allocation. The object is
+ *  constructed before the block is shared, so the block needs neither
+ *  a pointer to the object nor an initialized flag, and the allocator
+ *  is packed with the object, so empty allocators take no space.
+ *  Trivially destructible objects are not destroyed, unless the
+ *  allocator provides `destroy()`.
  *
  *  \synopsis
- *      template <typename T>
- *      class sp_ms_deleter
+ *      template <typename T, typename Allocator, sp_mode ThreadSafe>
+ *      class sp_counted_impl_array: public sp_counted_base<ThreadSafe>
  *      {
  *      public:
- *          sp_ms_deleter() noexcept;
- *          template <typename A> explicit sp_ms_deleter(const A&) noexcept;
- *          sp_ms_deleter(const sp_ms_deleter&) noexcept;
- *          ~sp_ms_deleter() noexcept;
- *          void operator()(T*) noexcept;
- *          static void operator_fn(T*) noexcept;
- *          void* address() noexcept;
- *          void set_initialized() noexcept;
+ *          static sp_counted_impl_array* create(const Allocator& alloc, size_t n);
+ *          T* data() noexcept;
+ *          void construct(size_t n, const T* u, size_t m);
+ *          void construct_default(size_t n);
+ *
+ *          void do_dispose();
+ *          void do_destroy();
+ *          void* do_get_deleter(const std::type_info&);
+ *          void* do_get_untyped_deleter();
  *      };
  *
- *      template <typename T, typename Allocator>
- *      class sp_as_deleter
+ *      template <typename T, typename Allocator, sp_mode ThreadSafe>
+ *      class sp_counted_impl_inplace: public sp_counted_base<ThreadSafe>
  *      {
  *      public:
- *          explicit sp_as_deleter(const Allocator& alloc) noexcept;
- *          sp_as_deleter(const sp_as_deleter& r) noexcept;
- *          ~sp_as_deleter() noexcept;
- *          void operator()(T*);
- *          static void operator_fn(T*) noexcept;
- *          void* address() noexcept;
- *          void set_initialized() noexcept;
+ *          template <typename ... Ts>
+ *          static sp_counted_impl_inplace* create(const Allocator& alloc, Ts&&... ts);
+ *          T* get() noexcept;
+ *
+ *          void do_dispose();
+ *          void do_destroy();
+ *          void* do_get_deleter(const std::type_info&);
+ *          void* do_get_untyped_deleter();
  *      };
  */
 
 #pragma once
 
+#include <pycpp/stl/container/compressed_pair.h>
 #include <pycpp/stl/memory/allocator.h>
 #include <pycpp/stl/memory/allocator_traits.h>
 #include <pycpp/stl/memory/shared_count.h>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
 #include <type_traits>
 
 PYCPP_BEGIN_NAMESPACE
 
+// HELPERS
+// -------
+
+template <typename Allocator, typename T, typename = void>
+struct sp_has_destroy: std::false_type
+{};
+
+template <typename Allocator, typename T>
+struct sp_has_destroy<Allocator, T, decltype(std::declval<Allocator&>().destroy(std::declval<T*>()), void())>: std::true_type
+{};
+
+// Storage unit for the control block and array elements.
+template <typename T, typename Impl>
+using sp_array_unit = typename std::aligned_storage<
+    alignof(T) < alignof(Impl) ? alignof(Impl) : alignof(T),
+    alignof(T) < alignof(Impl) ? alignof(Impl) : alignof(T)
+>::type;
+
 // OBJECTS
 // -------
 
-// SP MS DELETER
+// SP COUNTED IMPL ARRAY
 
-template <typename T>
-class sp_ms_deleter
+template <typename T, typename Allocator, sp_mode ThreadSafe>
+class sp_counted_impl_array: public sp_counted_base<ThreadSafe>
 {
 public:
+    using allocator_type = typename allocator_traits<Allocator>::template rebind_alloc<T>;
+    using alloc_traits = allocator_traits<allocator_type>;
 
-    sp_ms_deleter()
-    noexcept:
-        initialized_(false)
-    {}
+    sp_counted_impl_array(const sp_counted_impl_array&) = delete;
+    sp_counted_impl_array& operator=(const sp_counted_impl_array&) = delete;
 
-    template <typename Allocator>
-    explicit
-    sp_ms_deleter(
-        const Allocator&
+    // Allocate the control block, with storage for `n` elements.
+    static
+    sp_counted_impl_array*
+    create(
+        const Allocator& alloc,
+        size_t n
     )
-    noexcept:
-        initialized_(false)
-    {}
+    {
+        using unit_type = sp_array_unit<T, sp_counted_impl_array>;
+        using unit_allocator = typename allocator_traits<Allocator>::template rebind_alloc<unit_type>;
+        using unit_traits = allocator_traits<unit_allocator>;
 
-    // optimization: do not copy storage_
-    sp_ms_deleter(
-        const sp_ms_deleter&
-    )
-    noexcept:
-        initialized_(false)
-    {}
+        constexpr size_t max_size = std::numeric_limits<size_t>::max() - sizeof(unit_type);
+        if (n > (max_size - offset()) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        size_t units = (offset() + n * sizeof(T) + sizeof(unit_type) - 1) / sizeof(unit_type);
 
-    ~sp_ms_deleter()
+        unit_allocator a(alloc);
+        auto pu = unit_traits::allocate(a, units);
+        return ::new (static_cast<void*>(std::addressof(*pu))) sp_counted_impl_array(alloc, units);
+    }
+
+    T*
+    data()
     noexcept
     {
-        destroy();
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(this) + offset());
     }
 
+    // Initialize `n` elements, from the `m` values in `u`, repeated,
+    // or value-initialize them if `u` is null.
     void
-    operator()(
-        T*
+    construct(
+        size_t n,
+        const T* u,
+        size_t m
     )
-    noexcept
     {
-        destroy();
+        T* p = data();
+        try {
+            for (; size_ < n; ++size_) {
+                if (u) {
+                    alloc_traits::construct(alloc_, p + size_, u[size_ % m]);
+                } else {
+                    alloc_traits::construct(alloc_, p + size_);
+                }
+            }
+        } catch (...) {
+            do_dispose();
+            throw;
+        }
     }
 
-    static
+    // Default-initialize `n` elements.
     void
-    operator_fn(T*)
-    noexcept
-    {}
+    construct_default(
+        size_t n
+    )
+    {
+        default_ = true;
+        T* p = data();
+        try {
+            for (; size_ < n; ++size_) {
+                ::new (static_cast<void*>(p + size_)) T;
+            }
+        } catch (...) {
+            do_dispose();
+            throw;
+        }
+    }
 
-    void*
-    address()
-    noexcept
+    void
+    do_dispose()
     {
-        return static_cast<void*>(&storage_);
+        destroy_elements(std::integral_constant<bool,
+            std::is_trivially_destructible<T>::value &&
+            !sp_has_destroy<allocator_type, T>::value
+        >());
     }
 
     void
-    set_initialized()
-    noexcept
+    do_destroy()
     {
-        initialized_ = true;
+        using unit_type = sp_array_unit<T, sp_counted_impl_array>;
+        using unit_allocator = typename allocator_traits<Allocator>::template rebind_alloc<unit_type>;
+        using unit_traits = allocator_traits<unit_allocator>;
+        using unit_pointer = typename unit_traits::pointer;
+
+        unit_allocator a(alloc_);
+        size_t units = units_;
+        unit_type* pu = reinterpret_cast<unit_type*>(this);
+        this->~sp_counted_impl_array();
+        unit_traits::deallocate(a, std::pointer_traits<unit_pointer>::pointer_to(*pu), units);
+    }
+
+    void*
+    do_get_deleter(
+        const std::type_info&
+    )
+    {
+        return nullptr;
+    }
+
+    void*
+    do_get_untyped_deleter()
+    {
+        return nullptr;
     }
 
 private:
-    using storage_type = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+    allocator_type alloc_;
+    size_t size_;
+    size_t units_;
+    bool default_;
+
+    sp_counted_impl_array(
+        const Allocator& alloc,
+        size_t units
+    ):
+        sp_counted_base<ThreadSafe>(&sp_counted_manage<sp_counted_impl_array, ThreadSafe>),
+        alloc_(alloc),
+        size_(0),
+        units_(units),
+        default_(false)
+    {}
+
+    // Offset of the elements, after the control block.
+    static
+    constexpr
+    size_t
+    offset()
+    noexcept
+    {
+        return (sizeof(sp_counted_impl_array) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
 
-    bool initialized_;
-    storage_type storage_;
+    void
+    destroy_elements(
+        std::true_type
+    )
+    noexcept
+    {
+        size_ = 0;
+    }
 
     void
-    destroy()
+    destroy_elements(
+        std::false_type
+    )
     noexcept
     {
-        if (initialized_) {
-            T* p = static_cast<T*>(address());
-            p->~T();
-            initialized_ = false;
+        T* p = data();
+        while (size_ > 0) {
+            --size_;
+            if (default_) {
+                p[size_].~T();
+            } else {
+                alloc_traits::destroy(alloc_, p + size_);
+            }
         }
     }
 };
 
-// SP AS DELETER
+// SP COUNTED IMPL INPLACE
 
-template <typename T, typename Allocator>
-class sp_as_deleter
+template <typename T, typename Allocator, sp_mode ThreadSafe>
+class sp_counted_impl_inplace: public sp_counted_base<ThreadSafe>
 {
 public:
-    explicit
-    sp_as_deleter(
-        const Allocator& alloc
-    )
-    noexcept:
-        alloc_(alloc),
-        initialized_(false)
-    {}
+    using allocator_type = typename allocator_traits<Allocator>::template rebind_alloc<T>;
+    using alloc_traits = allocator_traits<allocator_type>;
+
+    sp_counted_impl_inplace(const sp_counted_impl_inplace&) = delete;
+    sp_counted_impl_inplace& operator=(const sp_counted_impl_inplace&) = delete;
 
-    // optimization: do not copy storage_
-    sp_as_deleter(
-        const sp_as_deleter& r
+    // Allocate the control block, and construct the object from `ts`.
+    template <typename ... Ts>
+    static
+    sp_counted_impl_inplace*
+    create(
+        const Allocator& alloc,
+        Ts&&... ts
     )
-    noexcept:
-        alloc_(r.alloc_),
-        initialized_(false)
-    {}
+    {
+        using impl_allocator = typename allocator_traits<Allocator>::template rebind_alloc<sp_counted_impl_inplace>;
+        using impl_traits = allocator_traits<impl_allocator>;
 
-    ~sp_as_deleter()
+        impl_allocator a(alloc);
+        auto pv = impl_traits::allocate(a, 1);
+        sp_counted_impl_inplace* pi = ::new (static_cast<void*>(std::addressof(*pv))) sp_counted_impl_inplace(alloc);
+        try {
+            alloc_traits::construct(pi->data_.first(), pi->get(), std::forward<Ts>(ts)...);
+        } catch (...) {
+            pi->~sp_counted_impl_inplace();
+            impl_traits::deallocate(a, pv, 1);
+            throw;
+        }
+
+        return pi;
+    }
+
+    T*
+    get()
     noexcept
     {
-        destroy();
+        return reinterpret_cast<T*>(&data_.second());
     }
 
     void
-    operator()(
-        T*
-    )
-    noexcept
+    do_dispose()
     {
-        destroy();
+        destroy_object(std::integral_constant<bool,
+            std::is_trivially_destructible<T>::value &&
+            !sp_has_destroy<allocator_type, T>::value
+        >());
     }
 
-    static
     void
-    operator_fn(T*)
-    noexcept
-    {}
+    do_destroy()
+    {
+        using impl_allocator = typename allocator_traits<Allocator>::template rebind_alloc<sp_counted_impl_inplace>;
+        using impl_traits = allocator_traits<impl_allocator>;
+        using impl_pointer = typename impl_traits::pointer;
+
+        impl_allocator a(data_.first());
+        impl_pointer p = std::pointer_traits<impl_pointer>::pointer_to(*this);
+        this->~sp_counted_impl_inplace();
+        impl_traits::deallocate(a, p, 1);
+    }
 
     void*
-    address()
-    noexcept
+    do_get_deleter(
+        const std::type_info&
+    )
     {
-        return static_cast<void*>(&storage_);
+        return nullptr;
     }
 
-    void
-    set_initialized()
-    noexcept
+    void*
+    do_get_untyped_deleter()
     {
-        initialized_ = true;
+        return nullptr;
     }
 
 private:
     using storage_type = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
 
-    storage_type storage_;
-    Allocator alloc_;
-    bool initialized_;
+    compressed_pair<allocator_type, storage_type> data_;
+
+    explicit
+    sp_counted_impl_inplace(
+        const Allocator& alloc
+    ):
+        sp_counted_base<ThreadSafe>(&sp_counted_manage<sp_counted_impl_inplace, ThreadSafe>),
+        data_(allocator_type(alloc))
+    {}
 
     void
-    destroy()
+    destroy_object(
+        std::true_type
+    )
+    noexcept
+    {}
+
+    void
+    destroy_object(
+        std::false_type
+    )
     noexcept
     {
-        if (initialized_) {
-            T* p = static_cast<T*>(address());
-            allocator_traits<Allocator>::destroy(alloc_, p);
-            initialized_ = false;
-        }
+        alloc_traits::destroy(data_.first(), get());
     }
 };
 
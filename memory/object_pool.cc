@@ -0,0 +1,231 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/stl/cstdlib/aligned_alloc.h>
+#include <pycpp/stl/memory/object_pool.h>
+#include <algorithm>
+#include <new>
+
+PYCPP_BEGIN_NAMESPACE
+
+// HELPERS
+// -------
+
+static
+size_t
+round_up(
+    size_t n,
+    size_t alignment
+)
+noexcept
+{
+    return (n + alignment - 1) & ~(alignment - 1);
+}
+
+// OBJECTS
+// -------
+
+// OBJECT POOL
+
+object_pool::object_pool(
+    size_t size,
+    size_t alignment
+)
+noexcept:
+    alignment_(std::max(alignment, alignof(pool_block))),
+    shared_(nullptr),
+    shared_count_(0),
+    capacity_(0),
+    chunks_(nullptr)
+{
+    size_ = round_up(std::max(size, sizeof(pool_block)), alignment_);
+}
+
+
+object_pool::~object_pool()
+{
+    pool_chunk* chunk = chunks_.load(std::memory_order_acquire);
+    while (chunk) {
+        pool_chunk* next = chunk->next;
+        aligned_free(chunk);
+        chunk = next;
+    }
+}
+
+
+void*
+object_pool::allocate()
+{
+    pool_record& r = records_.local<pool_record>();
+    pool_block* block = r.head;
+    if (block) {
+        r.head = block->next;
+        r.count.store(r.count.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        return block;
+    }
+
+    return refill(r);
+}
+
+
+void
+object_pool::deallocate(
+    void* p
+)
+noexcept
+{
+    pool_record& r = records_.local<pool_record>();
+    pool_block* block = static_cast<pool_block*>(p);
+    block->next = r.head;
+    r.head = block;
+
+    size_t count = r.count.load(std::memory_order_relaxed) + 1;
+    if (count <= PYCPP_OBJECT_POOL_CACHE) {
+        r.count.store(count, std::memory_order_relaxed);
+        return;
+    }
+
+    // return all but the most recently freed half in a single batch
+    size_t keep = PYCPP_OBJECT_POOL_CACHE / 2;
+    pool_block* last = r.head;
+    for (size_t i = 1; i < keep; ++i) {
+        last = last->next;
+    }
+    pool_block* first = last->next;
+    last->next = nullptr;
+    r.count.store(keep, std::memory_order_relaxed);
+
+    last = first;
+    while (last->next) {
+        last = last->next;
+    }
+    push_shared(first, last, count - keep);
+}
+
+
+size_t
+object_pool::block_size()
+const noexcept
+{
+    return size_;
+}
+
+
+size_t
+object_pool::block_alignment()
+const noexcept
+{
+    return alignment_;
+}
+
+
+pool_stats
+object_pool::stats()
+const noexcept
+{
+    size_t cached = 0;
+    for (thread_record* r = records_.head(); r; r = r->next_record) {
+        cached += static_cast<pool_record*>(r)->count.load(std::memory_order_relaxed);
+    }
+    size_t available = shared_count_.load(std::memory_order_relaxed);
+    size_t capacity = capacity_.load(std::memory_order_relaxed);
+    size_t free = cached + available;
+
+    return pool_stats {size_, capacity, capacity > free ? capacity - free : 0, cached, available};
+}
+
+
+auto
+object_pool::refill(
+    pool_record& r
+)
+    -> pool_block*
+{
+    // take a bounded batch from the shared list, or carve a new chunk
+    pool_block* block;
+    size_t count = pop_shared(block);
+    if (block == nullptr) {
+        block = allocate_chunk();
+        count = PYCPP_OBJECT_POOL_CHUNK;
+    }
+    r.head = block->next;
+    r.count.store(count - 1, std::memory_order_relaxed);
+
+    return block;
+}
+
+
+auto
+object_pool::allocate_chunk()
+    -> pool_block*
+{
+    size_t header = round_up(sizeof(pool_chunk), alignment_);
+    size_t count = PYCPP_OBJECT_POOL_CHUNK;
+    char* memory = static_cast<char*>(aligned_alloc(alignment_, header + count * size_));
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    pool_chunk* chunk = reinterpret_cast<pool_chunk*>(memory);
+    pool_chunk* old = chunks_.load(std::memory_order_relaxed);
+    do {
+        chunk->next = old;
+    } while (!chunks_.compare_exchange_weak(old, chunk, std::memory_order_release, std::memory_order_relaxed));
+    capacity_.fetch_add(count, std::memory_order_relaxed);
+
+    char* data = memory + header;
+    pool_block* first = reinterpret_cast<pool_block*>(data);
+    pool_block* block = first;
+    for (size_t i = 1; i < count; ++i) {
+        pool_block* next = reinterpret_cast<pool_block*>(data + i * size_);
+        block->next = next;
+        block = next;
+    }
+    block->next = nullptr;
+
+    return first;
+}
+
+
+void
+object_pool::push_shared(
+    pool_block* first,
+    pool_block* last,
+    size_t n
+)
+noexcept
+{
+    std::lock_guard<std::mutex> lock(shared_lock_);
+    last->next = shared_;
+    shared_ = first;
+    shared_count_.store(shared_count_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+
+// Take up to `PYCPP_OBJECT_POOL_BATCH` blocks, returning the number taken.
+size_t
+object_pool::pop_shared(
+    pool_block*& first
+)
+noexcept
+{
+    std::lock_guard<std::mutex> lock(shared_lock_);
+    first = shared_;
+    size_t count = shared_count_.load(std::memory_order_relaxed);
+    if (count > PYCPP_OBJECT_POOL_BATCH) {
+        pool_block* last = first;
+        for (size_t i = 1; i < PYCPP_OBJECT_POOL_BATCH; ++i) {
+            last = last->next;
+        }
+        shared_ = last->next;
+        last->next = nullptr;
+        shared_count_.store(count - PYCPP_OBJECT_POOL_BATCH, std::memory_order_relaxed);
+        return PYCPP_OBJECT_POOL_BATCH;
+    }
+
+    shared_ = nullptr;
+    shared_count_.store(0, std::memory_order_relaxed);
+    return count;
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,164 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Per-thread free-list pool for fixed-size objects.
+ *
+ *  `object_pool` serves blocks of a single size and alignment from a
+ *  free list owned by the calling thread, so allocation and
+ *  deallocation are a few plain loads and stores. Threads exchange
+ *  blocks through a shared list, guarded by a mutex: a thread freeing
+ *  more blocks than it caches, such as a consumer releasing objects
+ *  created by a producer, returns half of its cache in a single batch,
+ *  and a thread with an empty cache takes a bounded batch, so no
+ *  thread hoards the blocks freed by others.
+ *  Blocks are carved from chunks, which are only freed with the pool.
+ *
+ *  `object_pool::for_type<T>()` returns a pool for the size and
+ *  alignment of `T`, which is never destroyed, so objects may be
+ *  released during static destruction. Blocks cached by an exited
+ *  thread are reused by the next thread claiming its record.
+ *
+ *  `stats()` reports the pool's occupancy. Thread caches are read
+ *  without synchronization, so the counts are only a snapshot while
+ *  other threads use the pool.
+ *
+ *  \synopsis
+ *      struct pool_stats
+ *      {
+ *          size_t block_size;
+ *          size_t capacity;
+ *          size_t in_use;
+ *          size_t cached;
+ *          size_t available;
+ *      };
+ *
+ *      class object_pool
+ *      {
+ *      public:
+ *          object_pool(size_t size, size_t alignment) noexcept;
+ *          object_pool(const object_pool&) = delete;
+ *          object_pool& operator=(const object_pool&) = delete;
+ *          ~object_pool();
+ *
+ *          template <typename T> static object_pool& for_type() noexcept;
+ *
+ *          void* allocate();
+ *          void deallocate(void* p) noexcept;
+ *          size_t block_size() const noexcept;
+ *          size_t block_alignment() const noexcept;
+ *          pool_stats stats() const noexcept;
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory/thread_record.h>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+PYCPP_BEGIN_NAMESPACE
+
+// MACROS
+// ------
+
+// Blocks a thread may cache before returning half to the shared list.
+#ifndef PYCPP_OBJECT_POOL_CACHE
+#   define PYCPP_OBJECT_POOL_CACHE 256
+#endif
+
+// Blocks a thread takes from the shared list at once.
+#ifndef PYCPP_OBJECT_POOL_BATCH
+#   define PYCPP_OBJECT_POOL_BATCH (PYCPP_OBJECT_POOL_CACHE / 2)
+#endif
+
+// Blocks carved from each chunk.
+#ifndef PYCPP_OBJECT_POOL_CHUNK
+#   define PYCPP_OBJECT_POOL_CHUNK 64
+#endif
+
+// OBJECTS
+// -------
+
+// POOL STATS
+
+/**
+ *  \brief Occupancy of an object pool, in blocks.
+ */
+struct pool_stats
+{
+    size_t block_size;
+    size_t capacity;
+    size_t in_use;
+    size_t cached;
+    size_t available;
+};
+
+// OBJECT POOL
+
+/**
+ *  \brief Pool of fixed-size blocks with per-thread free lists.
+ */
+class object_pool
+{
+public:
+    object_pool(size_t size, size_t alignment) noexcept;
+    object_pool(const object_pool&) = delete;
+    object_pool& operator=(const object_pool&) = delete;
+    ~object_pool();
+
+    // Leaked, so it remains valid for threads exiting during static
+    // destruction.
+    template <typename T>
+    static
+    object_pool&
+    for_type()
+    noexcept
+    {
+        static object_pool* pool = new object_pool(sizeof(T), alignof(T));
+        return *pool;
+    }
+
+    void* allocate();
+    void deallocate(void* p) noexcept;
+    size_t block_size() const noexcept;
+    size_t block_alignment() const noexcept;
+    pool_stats stats() const noexcept;
+
+private:
+    struct pool_block
+    {
+        pool_block* next;
+    };
+
+    struct pool_chunk
+    {
+        pool_chunk* next;
+    };
+
+    // The count is only written by the owning thread, and is atomic so
+    // `stats()` may read it.
+    struct pool_record: thread_record
+    {
+        pool_block* head = nullptr;
+        std::atomic<size_t> count {0};
+    };
+
+    pool_block* refill(pool_record& r);
+    pool_block* allocate_chunk();
+    void push_shared(pool_block* first, pool_block* last, size_t n) noexcept;
+    size_t pop_shared(pool_block*& first) noexcept;
+
+    size_t size_;
+    size_t alignment_;
+    std::mutex shared_lock_;
+    pool_block* shared_;
+    // written under the lock, and atomic so `stats()` may read it
+    std::atomic<size_t> shared_count_;
+    std::atomic<size_t> capacity_;
+    std::atomic<pool_chunk*> chunks_;
+    thread_record_list records_;
+};
+
+PYCPP_END_NAMESPACE
@@ -5,16 +5,16 @@
  *  \brief Smart pointer type-casts.
  *
  *  \synopsis
- *      template <typename T, typename U, bool ThreadSafe>
+ *      template <typename T, typename U, sp_mode ThreadSafe>
  *      shared_ptr<T, ThreadSafe> static_pointer_cast(const shared_ptr<U, ThreadSafe>& r) noexcept;
  *
- *      template <typename T, typename U, bool ThreadSafe>
+ *      template <typename T, typename U, sp_mode ThreadSafe>
  *      shared_ptr<T, ThreadSafe> dynamic_pointer_cast(const shared_ptr<U, ThreadSafe>& r) noexcept;
  *
- *      template <typename T, typename U, bool ThreadSafe>
+ *      template <typename T, typename U, sp_mode ThreadSafe>
  *      shared_ptr<T, ThreadSafe> const_pointer_cast(const shared_ptr<U, ThreadSafe>& r) noexcept;
  *
- *      template <typename T, typename U, bool ThreadSafe>
+ *      template <typename T, typename U, sp_mode ThreadSafe>
  *      shared_ptr<T, ThreadSafe> reinterpret_pointer_cast(const shared_ptr<U, ThreadSafe>& r) noexcept;
  *
  *      template <typename T, typename U, typename TypeTraits>
@@ -42,7 +42,7 @@ PYCPP_BEGIN_NAMESPACE
 
 // SHARED PTR
 
-template <typename T, typename U, bool ThreadSafe>
+template <typename T, typename U, sp_mode ThreadSafe>
 inline
 shared_ptr<T, ThreadSafe>
 static_pointer_cast(
@@ -55,7 +55,7 @@ noexcept
 }
 
 
-template <typename T, typename U, bool ThreadSafe>
+template <typename T, typename U, sp_mode ThreadSafe>
 inline
 shared_ptr<T, ThreadSafe>
 dynamic_pointer_cast(
@@ -71,7 +71,7 @@ noexcept
 }
 
 
-template <typename T, typename U, bool ThreadSafe>
+template <typename T, typename U, sp_mode ThreadSafe>
 inline
 shared_ptr<T, ThreadSafe>
 const_pointer_cast(
@@ -84,7 +84,7 @@ noexcept
 }
 
 
-template <typename T, typename U, bool ThreadSafe>
+template <typename T, typename U, sp_mode ThreadSafe>
 inline
 shared_ptr<T, ThreadSafe>
 reinterpret_pointer_cast(
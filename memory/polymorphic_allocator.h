@@ -1,4 +1,21 @@
-// TODO:
-//polymorphic_allocator
-// Needs a `reallocate()` and `do_reallocate` set of functions
-// These call `std::allocator_traits` or the equivalent, by default.
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Polymorphic allocator exported from `<memory>`.
+ *
+ *  The polymorphic allocator forwards `reallocate` to the resource's
+ *  `do_reallocate`, so containers may grow in-place when the resource
+ *  supports it.
+ *
+ *  \synopsis
+ *      namespace pmr
+ *      {
+ *      template <typename T>
+ *      class polymorphic_allocator;
+ *      }   // pmr
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory_resource/polymorphic_allocator.h>
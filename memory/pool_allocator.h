@@ -0,0 +1,200 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Allocator and `make_shared` backed by per-type object pools.
+ *
+ *  `pool_allocator<T>` serves single objects from
+ *  `object_pool::for_type<T>()`, and forwards array requests to
+ *  `allocator<T>`. Rebinding the allocator selects the pool of the
+ *  rebound type, so node-based containers and `allocate_shared` draw
+ *  their nodes, or combined control blocks and objects, from a pool
+ *  dedicated to that node type.
+ *
+ *  `make_shared_pooled<T>` is `allocate_shared` with a
+ *  `pool_allocator<T>`, for types created and destroyed at high rates,
+ *  and `shared_pool_stats<T>` reports the occupancy of its pool.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      class pool_allocator
+ *      {
+ *      public:
+ *          using value_type = T;
+ *          using size_type = size_t;
+ *          using difference_type = ptrdiff_t;
+ *          using propagate_on_container_move_assignment = true_type;
+ *          using is_always_equal = true_type;
+ *
+ *          template <typename U>
+ *          struct rebind
+ *          {
+ *              using other = pool_allocator<U>;
+ *          };
+ *
+ *          pool_allocator() noexcept;
+ *          pool_allocator(const pool_allocator&) noexcept;
+ *          template <typename U> pool_allocator(const pool_allocator<U>&) noexcept;
+ *
+ *          T* allocate(size_t n);
+ *          void deallocate(T* p, size_t n) noexcept;
+ *          size_t max_size() const noexcept;
+ *      };
+ *
+ *      template <typename T1, typename T2>
+ *      bool operator==(const pool_allocator<T1>&, const pool_allocator<T2>&) noexcept;
+ *
+ *      template <typename T1, typename T2>
+ *      bool operator!=(const pool_allocator<T1>&, const pool_allocator<T2>&) noexcept;
+ *
+ *      template <typename T, sp_mode ThreadSafe, typename ... Ts>
+ *      shared_ptr<T, ThreadSafe> make_shared_pooled(Ts&&... ts);
+ *
+ *      template <typename T, typename ... Ts>
+ *      shared_ptr<T, true> make_shared_pooled(Ts&&... ts);
+ *
+ *      template <typename T, sp_mode ThreadSafe = true>
+ *      pool_stats shared_pool_stats() noexcept;
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory/allocator.h>
+#include <pycpp/stl/memory/object_pool.h>
+#include <pycpp/stl/memory/shared_ptr.h>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+/**
+ *  \brief Stateless allocator serving single objects from a pool.
+ */
+template <typename T>
+class pool_allocator
+{
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = pool_allocator<U>;
+    };
+
+    // Constructors
+    pool_allocator() noexcept = default;
+    pool_allocator(const pool_allocator&) noexcept = default;
+    pool_allocator& operator=(const pool_allocator&) noexcept = default;
+
+    template <typename U>
+    pool_allocator(
+        const pool_allocator<U>&
+    )
+    noexcept
+    {}
+
+    // Allocator traits
+    T*
+    allocate(
+        size_t n
+    )
+    {
+        if (n == 1) {
+            return static_cast<T*>(object_pool::for_type<T>().allocate());
+        }
+        return allocator<T>().allocate(n);
+    }
+
+    void
+    deallocate(
+        T* p,
+        size_t n
+    )
+    noexcept
+    {
+        if (n == 1) {
+            object_pool::for_type<T>().deallocate(p);
+        } else {
+            allocator<T>().deallocate(p, n);
+        }
+    }
+
+    size_t
+    max_size()
+    const noexcept
+    {
+        return std::numeric_limits<size_t>::max() / sizeof(T);
+    }
+};
+
+template <typename T1, typename T2>
+inline
+bool
+operator==(
+    const pool_allocator<T1>&,
+    const pool_allocator<T2>&
+)
+noexcept
+{
+    return true;
+}
+
+
+template <typename T1, typename T2>
+inline
+bool
+operator!=(
+    const pool_allocator<T1>&,
+    const pool_allocator<T2>&
+)
+noexcept
+{
+    return false;
+}
+
+// FUNCTIONS
+// ---------
+
+template <typename T, sp_mode ThreadSafe, typename ... Ts>
+inline
+sp_disable_if_array_t<T, shared_ptr<T, ThreadSafe>>
+make_shared_pooled(
+    Ts&&... ts
+)
+{
+    return allocate_shared<T, ThreadSafe>(pool_allocator<T>(), std::forward<Ts>(ts)...);
+}
+
+
+template <typename T, typename ... Ts>
+inline
+sp_disable_if_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+make_shared_pooled(
+    Ts&&... ts
+)
+{
+    return make_shared_pooled<T, PYCPP_SP_THREAD_SAFE>(std::forward<Ts>(ts)...);
+}
+
+
+template <typename T, sp_mode ThreadSafe = PYCPP_SP_THREAD_SAFE>
+inline
+pool_stats
+shared_pool_stats()
+noexcept
+{
+    using block_type = sp_counted_impl_inplace<T, pool_allocator<T>, ThreadSafe>;
+    return object_pool::for_type<block_type>().stats();
+}
+
+PYCPP_END_NAMESPACE
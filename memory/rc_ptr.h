@@ -0,0 +1,486 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Reference-counted pointer without weak references.
+ *
+ *  `rc_ptr` shares ownership of an object like `shared_ptr`, but its
+ *  control block holds only a use count, and the object is stored
+ *  directly after it, in a single allocation from `allocator<T>`.
+ *  Without a weak count, releasing the last reference costs a single
+ *  atomic decrement, rather than one for the use count and another for
+ *  the weak count, and the block needs neither a weak count nor a
+ *  deleter. `rc_ptr` itself is a single pointer.
+ *
+ *  Since the block knows the exact type of the object, `rc_ptr<T>`
+ *  does not convert to `rc_ptr<Base>`, and has no aliasing or custom
+ *  deleter constructors. Objects may only be created with `make_rc`.
+ *  `rc_ptr` does not convert to `shared_ptr`, so constructing a
+ *  `weak_ptr` from it fails to compile.
+ *
+ *  \synopsis
+ *      template <typename T, bool ThreadSafe = true>
+ *      class rc_ptr
+ *      {
+ *      public:
+ *          using element_type = T;
+ *          static constexpr bool thread_safe = ThreadSafe;
+ *
+ *          constexpr rc_ptr() noexcept;
+ *          constexpr rc_ptr(nullptr_t) noexcept;
+ *          rc_ptr(const rc_ptr& r) noexcept;
+ *          rc_ptr(rc_ptr&& r) noexcept;
+ *          ~rc_ptr();
+ *
+ *          rc_ptr& operator=(const rc_ptr& r) noexcept;
+ *          rc_ptr& operator=(rc_ptr&& r) noexcept;
+ *          rc_ptr& operator=(nullptr_t) noexcept;
+ *
+ *          void reset() noexcept;
+ *          void swap(rc_ptr& r) noexcept;
+ *
+ *          element_type* get() const noexcept;
+ *          element_type& operator*() const noexcept;
+ *          element_type* operator->() const noexcept;
+ *          long use_count() const noexcept;
+ *          bool unique() const noexcept;
+ *          explicit operator bool() const noexcept;
+ *          explicit operator element_type*() const noexcept;
+ *      };
+ *
+ *      template <typename T, bool ThreadSafe, typename ... Ts>
+ *      rc_ptr<T, ThreadSafe> make_rc(Ts&&... ts);
+ *
+ *      template <typename T, typename ... Ts>
+ *      rc_ptr<T> make_rc(Ts&&... ts);
+ *
+ *      template <typename T, bool TS1, typename U, bool TS2>
+ *      bool operator==(const rc_ptr<T, TS1>& x, const rc_ptr<U, TS2>& y) noexcept;
+ *
+ *      template <typename T, bool TS1, typename U, bool TS2>
+ *      bool operator!=(const rc_ptr<T, TS1>& x, const rc_ptr<U, TS2>& y) noexcept;
+ *
+ *      template <typename T, bool TS1, typename U, bool TS2>
+ *      bool operator<(const rc_ptr<T, TS1>& x, const rc_ptr<U, TS2>& y) noexcept;
+ *
+ *      template <typename T, bool ThreadSafe>
+ *      bool operator==(const rc_ptr<T, ThreadSafe>& x, nullptr_t) noexcept;
+ *
+ *      template <typename T, bool ThreadSafe>
+ *      bool operator==(nullptr_t, const rc_ptr<T, ThreadSafe>& x) noexcept;
+ *
+ *      template <typename T, bool ThreadSafe>
+ *      bool operator!=(const rc_ptr<T, ThreadSafe>& x, nullptr_t) noexcept;
+ *
+ *      template <typename T, bool ThreadSafe>
+ *      bool operator!=(nullptr_t, const rc_ptr<T, ThreadSafe>& x) noexcept;
+ *
+ *      template <typename T, bool ThreadSafe>
+ *      void swap(rc_ptr<T, ThreadSafe>& x, rc_ptr<T, ThreadSafe>& y) noexcept;
+ *
+ *      template <typename T, bool ThreadSafe>
+ *      struct hash<rc_ptr<T, ThreadSafe>>;
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory/allocator.h>
+#include <pycpp/stl/memory/intrusive_ref_counter.h>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+PYCPP_BEGIN_NAMESPACE
+
+// FORWARD
+// -------
+
+template <typename T, bool ThreadSafe>
+class rc_ptr;
+
+template <typename T, bool ThreadSafe, typename ... Ts>
+rc_ptr<T, ThreadSafe>
+make_rc(
+    Ts&&... ts
+);
+
+// OBJECTS
+// -------
+
+// RC BLOCK
+
+template <typename T, bool ThreadSafe>
+struct rc_block
+{
+    template <typename ... Ts>
+    explicit
+    rc_block(
+        Ts&&... ts
+    ):
+        count(1),
+        value(std::forward<Ts>(ts)...)
+    {}
+
+    intrusive_ref_count<ThreadSafe> count;
+    T value;
+};
+
+// RC PTR
+
+template <typename T, bool ThreadSafe = PYCPP_SP_THREAD_SAFE>
+class rc_ptr
+{
+    static_assert(!std::is_array<T>::value, "rc_ptr does not support arrays.");
+
+    using block_type = rc_block<T, ThreadSafe>;
+    using allocator_type = allocator<block_type>;
+
+public:
+    using element_type = T;
+    static constexpr bool thread_safe = ThreadSafe;
+
+    // CONSTRUCTORS
+
+    constexpr
+    rc_ptr()
+    noexcept:
+        block_(nullptr)
+    {}
+
+    constexpr
+    rc_ptr(
+        std::nullptr_t
+    )
+    noexcept:
+        block_(nullptr)
+    {}
+
+    rc_ptr(
+        const rc_ptr& r
+    )
+    noexcept:
+        block_(r.block_)
+    {
+        if (block_) {
+            block_->count.increment();
+        }
+    }
+
+    rc_ptr(
+        rc_ptr&& r
+    )
+    noexcept:
+        block_(r.block_)
+    {
+        r.block_ = nullptr;
+    }
+
+    ~rc_ptr()
+    {
+        release(block_);
+    }
+
+    // ASSIGNMENT
+
+    rc_ptr&
+    operator=(
+        const rc_ptr& r
+    )
+    noexcept
+    {
+        rc_ptr(r).swap(*this);
+        return *this;
+    }
+
+    rc_ptr&
+    operator=(
+        rc_ptr&& r
+    )
+    noexcept
+    {
+        rc_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+
+    rc_ptr&
+    operator=(
+        std::nullptr_t
+    )
+    noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    // MODIFIERS
+
+    void
+    reset()
+    noexcept
+    {
+        block_type* b = block_;
+        block_ = nullptr;
+        release(b);
+    }
+
+    void
+    swap(
+        rc_ptr& r
+    )
+    noexcept
+    {
+        std::swap(block_, r.block_);
+    }
+
+    // OBSERVERS
+
+    element_type*
+    get()
+    const noexcept
+    {
+        return block_ ? &block_->value : nullptr;
+    }
+
+    element_type&
+    operator*()
+    const noexcept
+    {
+        return block_->value;
+    }
+
+    element_type*
+    operator->()
+    const noexcept
+    {
+        return &block_->value;
+    }
+
+    long
+    use_count()
+    const noexcept
+    {
+        return block_ ? block_->count.load() : 0;
+    }
+
+    bool
+    unique()
+    const noexcept
+    {
+        return use_count() == 1;
+    }
+
+    explicit
+    operator bool()
+    const noexcept
+    {
+        return block_ != nullptr;
+    }
+
+    explicit
+    operator element_type*()
+    const noexcept
+    {
+        return get();
+    }
+
+private:
+    template <typename U, bool TS, typename ... Ts>
+    friend
+    rc_ptr<U, TS>
+    make_rc(
+        Ts&&... ts
+    );
+
+    explicit
+    rc_ptr(
+        block_type* b
+    )
+    noexcept:
+        block_(b)
+    {}
+
+    static
+    void
+    release(
+        block_type* b
+    )
+    noexcept
+    {
+        if (b && b->count.decrement()) {
+            b->~block_type();
+            allocator_type().deallocate(b, 1);
+        }
+    }
+
+    block_type* block_;
+};
+
+// FUNCTIONS
+// ---------
+
+// MAKE RC
+
+template <typename T, bool ThreadSafe, typename ... Ts>
+inline
+rc_ptr<T, ThreadSafe>
+make_rc(
+    Ts&&... ts
+)
+{
+    using block_type = rc_block<T, ThreadSafe>;
+
+    allocator<block_type> alloc;
+    block_type* b = alloc.allocate(1);
+    try {
+        ::new (static_cast<void*>(b)) block_type(std::forward<Ts>(ts)...);
+    } catch (...) {
+        alloc.deallocate(b, 1);
+        throw;
+    }
+
+    return rc_ptr<T, ThreadSafe>(b);
+}
+
+
+template <typename T, typename ... Ts>
+inline
+rc_ptr<T>
+make_rc(
+    Ts&&... ts
+)
+{
+    return make_rc<T, PYCPP_SP_THREAD_SAFE>(std::forward<Ts>(ts)...);
+}
+
+// RELATIONAL OPERATORS
+
+template <typename T, bool TS1, typename U, bool TS2>
+inline
+bool
+operator==(
+    const rc_ptr<T, TS1>& x,
+    const rc_ptr<U, TS2>& y
+)
+noexcept
+{
+    return x.get() == y.get();
+}
+
+
+template <typename T, bool TS1, typename U, bool TS2>
+inline
+bool
+operator!=(
+    const rc_ptr<T, TS1>& x,
+    const rc_ptr<U, TS2>& y
+)
+noexcept
+{
+    return !(x == y);
+}
+
+
+template <typename T, bool TS1, typename U, bool TS2>
+inline
+bool
+operator<(
+    const rc_ptr<T, TS1>& x,
+    const rc_ptr<U, TS2>& y
+)
+noexcept
+{
+    using V = typename std::common_type<T*, U*>::type;
+    return std::less<V>()(x.get(), y.get());
+}
+
+
+template <typename T, bool ThreadSafe>
+inline
+bool
+operator==(
+    const rc_ptr<T, ThreadSafe>& x,
+    std::nullptr_t
+)
+noexcept
+{
+    return !x;
+}
+
+
+template <typename T, bool ThreadSafe>
+inline
+bool
+operator==(
+    std::nullptr_t,
+    const rc_ptr<T, ThreadSafe>& x
+)
+noexcept
+{
+    return !x;
+}
+
+
+template <typename T, bool ThreadSafe>
+inline
+bool
+operator!=(
+    const rc_ptr<T, ThreadSafe>& x,
+    std::nullptr_t
+)
+noexcept
+{
+    return static_cast<bool>(x);
+}
+
+
+template <typename T, bool ThreadSafe>
+inline
+bool
+operator!=(
+    std::nullptr_t,
+    const rc_ptr<T, ThreadSafe>& x
+)
+noexcept
+{
+    return static_cast<bool>(x);
+}
+
+// SWAP
+
+template <typename T, bool ThreadSafe>
+inline
+void
+swap(
+    rc_ptr<T, ThreadSafe>& x,
+    rc_ptr<T, ThreadSafe>& y
+)
+noexcept
+{
+    x.swap(y);
+}
+
+// SPECIALIZATION
+// --------------
+
+template <typename T>
+struct hash;
+
+template <typename T, bool ThreadSafe>
+struct hash<rc_ptr<T, ThreadSafe>>
+{
+    using argument_type = rc_ptr<T, ThreadSafe>;
+
+    inline
+    size_t
+    operator()(
+        const argument_type& x
+    )
+    const noexcept
+    {
+        return hash<T*>()(x.get());
+    }
+};
+
+PYCPP_END_NAMESPACE
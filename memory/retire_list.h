@@ -0,0 +1,253 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Retired objects awaiting safe memory reclamation.
+ *
+ *  Objects removed from a concurrent data structure are retired with a
+ *  deleter, in a type-erased node allocated from a memory resource,
+ *  and reclaimed once no thread may still access them. Nodes are kept
+ *  in intrusive, singly-linked lists, so retiring does not allocate
+ *  beyond the node itself.
+ *
+ *  \synopsis
+ *      struct retired_node
+ *      {
+ *          retired_node* next;
+ *          const void* ptr;
+ *          void reclaim() noexcept;
+ *      };
+ *
+ *      template <typename T>
+ *      struct resource_deleter
+ *      {
+ *          pmr::memory_resource* resource;
+ *          void operator()(T* p) const noexcept;
+ *      };
+ *
+ *      template <typename T, typename Deleter>
+ *      retired_node* make_retired(pmr::memory_resource* r, T* p, Deleter d);
+ *
+ *      class retire_list
+ *      {
+ *      public:
+ *          retire_list() noexcept;
+ *          retire_list(const retire_list&) = delete;
+ *          retire_list& operator=(const retire_list&) = delete;
+ *          ~retire_list();
+ *
+ *          size_t size() const noexcept;
+ *          bool empty() const noexcept;
+ *          void push(retired_node* n) noexcept;
+ *          void splice(retire_list& other) noexcept;
+ *          retired_node* take() noexcept;
+ *          void reclaim() noexcept;
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory_resource/polymorphic_allocator.h>
+#include <new>
+#include <utility>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+// RETIRED NODE
+
+/**
+ *  \brief Type-erased retired object.
+ */
+struct retired_node
+{
+    retired_node* next;
+    const void* ptr;
+    void (*reclaim_)(retired_node*) noexcept;
+
+    // Invoke the deleter and free the node.
+    void
+    reclaim()
+    noexcept
+    {
+        reclaim_(this);
+    }
+};
+
+// RESOURCE DELETER
+
+/**
+ *  \brief Destroy an object and return its memory to a resource.
+ */
+template <typename T>
+struct resource_deleter
+{
+    pmr::memory_resource* resource;
+
+    void
+    operator()(
+        T* p
+    )
+    const noexcept
+    {
+        p->~T();
+        resource->deallocate(p, sizeof(T), alignof(T));
+    }
+};
+
+// RETIRED OBJECT
+
+template <typename T, typename Deleter>
+struct retired_object: retired_node
+{
+    T* object;
+    Deleter deleter;
+    pmr::memory_resource* resource;
+
+    // Deleters need not be default-constructible nor assignable, IE, lambdas.
+    retired_object(
+        T* p,
+        Deleter&& d,
+        pmr::memory_resource* r
+    ):
+        retired_node {nullptr, p, &do_reclaim},
+        object(p),
+        deleter(std::move(d)),
+        resource(r)
+    {}
+
+    static
+    void
+    do_reclaim(
+        retired_node* n
+    )
+    noexcept
+    {
+        retired_object* self = static_cast<retired_object*>(n);
+        pmr::memory_resource* r = self->resource;
+        self->deleter(self->object);
+        self->~retired_object();
+        r->deallocate(self, sizeof(retired_object), alignof(retired_object));
+    }
+};
+
+// RETIRE LIST
+
+/**
+ *  \brief Intrusive list of retired nodes, owned by a single thread.
+ */
+class retire_list
+{
+public:
+    retire_list()
+    noexcept:
+        head_(nullptr),
+        size_(0)
+    {}
+
+    retire_list(const retire_list&) = delete;
+    retire_list& operator=(const retire_list&) = delete;
+
+    ~retire_list()
+    {
+        reclaim();
+    }
+
+    size_t
+    size()
+    const noexcept
+    {
+        return size_;
+    }
+
+    bool
+    empty()
+    const noexcept
+    {
+        return head_ == nullptr;
+    }
+
+    void
+    push(
+        retired_node* n
+    )
+    noexcept
+    {
+        n->next = head_;
+        head_ = n;
+        ++size_;
+    }
+
+    void
+    splice(
+        retire_list& other
+    )
+    noexcept
+    {
+        retired_node* n = other.take();
+        while (n) {
+            retired_node* next = n->next;
+            push(n);
+            n = next;
+        }
+    }
+
+    // Detach all nodes, as a null-terminated list.
+    retired_node*
+    take()
+    noexcept
+    {
+        retired_node* head = head_;
+        head_ = nullptr;
+        size_ = 0;
+        return head;
+    }
+
+    void
+    reclaim()
+    noexcept
+    {
+        retired_node* n = take();
+        while (n) {
+            retired_node* next = n->next;
+            n->reclaim();
+            n = next;
+        }
+    }
+
+private:
+    retired_node* head_;
+    size_t size_;
+};
+
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief Allocate a retired node for `p` from the resource.
+ */
+template <typename T, typename Deleter>
+retired_node*
+make_retired(
+    pmr::memory_resource* r,
+    T* p,
+    Deleter d
+)
+{
+    using node_type = retired_object<T, Deleter>;
+
+    void* pv = r->allocate(sizeof(node_type), alignof(node_type));
+    node_type* n;
+    try {
+        n = ::new (pv) node_type(p, std::move(d), r);
+    } catch (...) {
+        r->deallocate(pv, sizeof(node_type), alignof(node_type));
+        throw;
+    }
+
+    return n;
+}
+
+PYCPP_END_NAMESPACE
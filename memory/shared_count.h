@@ -10,7 +10,15 @@
  *  atomic variables, which have generally better performance than
  *  spinlocks (and compile-down to a single `LOCK` instruction).
  *  The non-thread-safe versions use raw numeric types, for
- *  faster performance.
+ *  faster performance. The biased versions, selected with `SP_BIASED`,
+ *  bias the atomic counts towards the creating thread, which then
+ *  avoids atomic read-modify-write operations (see `biased_count.h`).
+ *
+ *  Control blocks dispatch disposal and destruction through a single
+ *  function pointer, chosen when the block is created, rather than a
+ *  virtual table, saving a dependent load per call. Deleters and
+ *  allocators are packed with `compressed_pair`, so empty ones take
+ *  no space.
  *
  *  \synopsis
  *      class bad_weak_ptr: public std::exception
@@ -19,19 +27,21 @@
  *          virtual char const* what() const throw();
  *      };
  *
- *      template <bool ThreadSafe>
+ *      template <sp_mode ThreadSafe>
  *      class sp_counted_base
  *      {
  *      public:
- *          sp_counted_base();
+ *          using manager_type = sp_manager<ThreadSafe>;
+ *
+ *          explicit sp_counted_base(manager_type manager);
  *          sp_counted_base(const sp_counted_base&) = delete;
  *          sp_counted_base& operator=(const sp_counted_base&) = delete;
- *          virtual ~sp_counted_base();
+ *          ~sp_counted_base();
  *
- *          virtual void dispose() = 0;
- *          virtual void destroy();
- *          virtual void* get_deleter(const std::type_info&) = 0;
- *          virtual void* get_untyped_deleter() = 0;
+ *          void dispose();
+ *          void destroy();
+ *          void* get_deleter(const std::type_info&);
+ *          void* get_untyped_deleter();
  *          void add_ref_copy();
  *          bool add_ref_lock();
  *          void release();
@@ -40,12 +50,12 @@
  *          long use_count() const;
  *      };
  *
- *      template <bool ThreadSafe>
+ *      template <sp_mode ThreadSafe>
  *      class shared_count
  *      {
  *      public:
  *          using count_type = sp_counted_base<ThreadSafe>;
- *          static constexpr bool thread_safe = ThreadSafe;
+ *          static constexpr sp_mode thread_safe = ThreadSafe;
  *
  *          constexpr shared_count() noexcept;
  *          shared_count(const shared_count& r);
@@ -66,6 +76,8 @@
  *          template <typename U, typename Deleter>
  *          explicit shared_count(std::unique_ptr<U, Deleter>& r);
  *
+ *          shared_count(count_type* pi, sp_adopt_t) noexcept;
+ *
  *          void swap(shared_count& r);
  *          bool unique() const;
  *          long use_count() const;
@@ -78,12 +90,12 @@
  *          void* get_untyped_deleter() const;
  *      };
  *
- *      template <bool ThreadSafe>
+ *      template <sp_mode ThreadSafe>
  *      class weak_count
  *      {
  *      public:
  *          using count_type = sp_counted_base<ThreadSafe>;
- *          static constexpr bool thread_safe = ThreadSafe;
+ *          static constexpr sp_mode thread_safe = ThreadSafe;
  *
  *          constexpr weak_count() noexcept;
  *          weak_count(const shared_count<thread_safe>& r) noexcept;
@@ -104,8 +116,11 @@
 
 #pragma once
 
+#include <pycpp/stl/container/compressed_pair.h>
 #include <pycpp/stl/memory/allocator_traits.h>
+#include <pycpp/stl/memory/biased_count.h>
 #include <pycpp/stl/memory/checked_delete.h>
+#include <pycpp/stl/memory/sp_mode.h>
 #include <pycpp/stl/thread/checked_thread.h>
 #include <atomic>
 #include <cstdint>
@@ -125,19 +140,19 @@ PYCPP_BEGIN_NAMESPACE
 // FORWARD
 // -------
 
-template <typename T, bool ThreadSafe = PYCPP_SP_THREAD_SAFE>
+template <typename T, sp_mode ThreadSafe = PYCPP_SP_THREAD_SAFE>
 class shared_ptr;
 
-template <typename T, bool ThreadSafe = PYCPP_SP_THREAD_SAFE>
+template <typename T, sp_mode ThreadSafe = PYCPP_SP_THREAD_SAFE>
 class weak_ptr;
 
-template <typename T, bool ThreadSafe = PYCPP_SP_THREAD_SAFE>
+template <typename T, sp_mode ThreadSafe = PYCPP_SP_THREAD_SAFE>
 class enable_shared_from_this;
 
-template <bool ThreadSafe = PYCPP_SP_THREAD_SAFE>
+template <sp_mode ThreadSafe = PYCPP_SP_THREAD_SAFE>
 class shared_count;
 
-template <bool ThreadSafe = PYCPP_SP_THREAD_SAFE>
+template <sp_mode ThreadSafe = PYCPP_SP_THREAD_SAFE>
 class weak_count;
 
 template <typename T>
@@ -203,16 +218,210 @@ public:
 
 // SP COUNTED BASE
 
-template <bool ThreadSafe>
+template <sp_mode ThreadSafe>
 class sp_counted_base;
 
+// Operations on the derived control block, dispatched through a
+// single function pointer chosen when the block is created, rather
+// than a virtual table.
+enum class sp_op
+{
+    dispose,
+    destroy,
+    get_deleter,
+    get_untyped_deleter,
+};
+
+template <sp_mode ThreadSafe>
+using sp_manager = void* (*)(sp_counted_base<ThreadSafe>*, sp_op, const std::type_info*);
+
+// Thread-safe, biased towards the creating thread.
+template <>
+class sp_counted_base<SP_BIASED>
+{
+public:
+    using manager_type = sp_manager<SP_BIASED>;
+
+    explicit
+    sp_counted_base(
+        manager_type manager
+    ):
+        manager_(manager),
+        weak_count_(1),
+        next_queued_(nullptr)
+    {
+        uintptr_t owner = sp_biased_register();
+        owner_.store(owner, std::memory_order_relaxed);
+        if (owner == SP_BIASED_NO_OWNER) {
+            local_.store(0, std::memory_order_relaxed);
+            shared_.store(SP_BIASED_ONE | SP_BIASED_MERGED, std::memory_order_relaxed);
+        } else {
+            local_.store(1, std::memory_order_relaxed);
+            shared_.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    sp_counted_base(const sp_counted_base&) = delete;
+    sp_counted_base& operator=(const sp_counted_base&) = delete;
+
+    ~sp_counted_base() = default;
+
+    void
+    dispose()
+    {
+        manager_(this, sp_op::dispose, nullptr);
+    }
+
+    void
+    destroy()
+    {
+        manager_(this, sp_op::destroy, nullptr);
+    }
+
+    void*
+    get_deleter(
+        const std::type_info& ti
+    )
+    {
+        return manager_(this, sp_op::get_deleter, &ti);
+    }
+
+    void*
+    get_untyped_deleter()
+    {
+        return manager_(this, sp_op::get_untyped_deleter, nullptr);
+    }
+
+    void
+    add_ref_copy()
+    {
+        if (is_owner()) {
+            add_local(1);
+        } else {
+            shared_.fetch_add(SP_BIASED_ONE, std::memory_order_relaxed);
+        }
+    }
+
+    bool
+    add_ref_lock()
+    {
+        // the owner holds a local reference until the counts are merged
+        if (is_owner()) {
+            add_local(1);
+            return true;
+        }
+
+        std::int_least32_t r = shared_.load(std::memory_order_relaxed);
+        do {
+            if (r == SP_BIASED_MERGED) {
+                return false;
+            }
+        } while (!shared_.compare_exchange_weak(r, r + SP_BIASED_ONE, std::memory_order_relaxed, std::memory_order_relaxed));
+
+        return true;
+    }
+
+    void
+    release()
+    {
+        if (!is_owner()) {
+            release_shared();
+        } else if (add_local(-1) == 0) {
+            merge_zero_local();
+        }
+    }
+
+    void
+    weak_add_ref()
+    {
+        atomic_increment(&weak_count_);
+    }
+
+    void
+    weak_release()
+    {
+        if (atomic_decrement( &weak_count_ ) == 1) {
+            destroy();
+        }
+    }
+
+    long
+    use_count()
+    const
+    {
+        std::int_least32_t shared = shared_.load(std::memory_order_acquire);
+        std::int_least32_t local = local_.load(std::memory_order_relaxed);
+        return static_cast<long>((shared - (shared & SP_BIASED_FLAGS)) / SP_BIASED_ONE + local);
+    }
+
+private:
+    friend void sp_biased_queue(sp_counted_base<SP_BIASED>*, uintptr_t) noexcept;
+    friend void sp_biased_merge() noexcept;
+    friend struct sp_biased_flusher;
+
+    bool
+    is_owner()
+    const noexcept
+    {
+        return owner_.load(std::memory_order_relaxed) == sp_biased_local().id;
+    }
+
+    // Only the owner writes the local count, so avoid
+    // a read-modify-write.
+    std::int_least32_t
+    add_local(
+        std::int_least32_t n
+    )
+    noexcept
+    {
+        std::int_least32_t local = local_.load(std::memory_order_relaxed) + n;
+        local_.store(local, std::memory_order_relaxed);
+        return local;
+    }
+
+    void
+    release_shared()
+    {
+        // if the shared count would drop below zero before the counts
+        // are merged, queue the object for the owner, keeping the reference.
+        std::int_least32_t r = shared_.load(std::memory_order_relaxed);
+        std::int_least32_t value;
+        do {
+            value = r == 0 ? SP_BIASED_QUEUED : r - SP_BIASED_ONE;
+        } while (!shared_.compare_exchange_weak(r, value, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+        if (r == 0) {
+            sp_biased_queue(this, owner_.load(std::memory_order_relaxed));
+        } else if (value == SP_BIASED_MERGED) {
+            dispose();
+            weak_release();
+        }
+    }
+
+    void merge_zero_local();
+    void merge_queued();
+
+    manager_type manager_;
+    std::atomic<uintptr_t> owner_;
+    std::atomic_int_least32_t local_;
+    std::atomic_int_least32_t shared_;
+    std::atomic_int_least32_t weak_count_;
+    sp_counted_base* next_queued_;
+};
+
+
 // Thread-safe
 template <>
 class sp_counted_base<true>
 {
 public:
-    constexpr
-    sp_counted_base():
+    using manager_type = sp_manager<true>;
+
+    explicit constexpr
+    sp_counted_base(
+        manager_type manager
+    ):
+        manager_(manager),
         use_count_(1),
         weak_count_(1)
     {}
@@ -220,21 +429,33 @@ public:
     sp_counted_base(const sp_counted_base&) = delete;
     sp_counted_base& operator=(const sp_counted_base&) = delete;
 
-    virtual
-    ~sp_counted_base()
-    {}
+    ~sp_counted_base() = default;
 
-    virtual void dispose() = 0;
+    void
+    dispose()
+    {
+        manager_(this, sp_op::dispose, nullptr);
+    }
 
-    virtual
     void
     destroy()
     {
-        delete this;
+        manager_(this, sp_op::destroy, nullptr);
     }
 
-    virtual void* get_deleter(const std::type_info&) = 0;
-    virtual void* get_untyped_deleter() = 0;
+    void*
+    get_deleter(
+        const std::type_info& ti
+    )
+    {
+        return manager_(this, sp_op::get_deleter, &ti);
+    }
+
+    void*
+    get_untyped_deleter()
+    {
+        return manager_(this, sp_op::get_untyped_deleter, nullptr);
+    }
 
     void
     add_ref_copy()
@@ -279,6 +500,7 @@ public:
     }
 
 private:
+    manager_type manager_;
     std::atomic_int_least32_t use_count_;
     std::atomic_int_least32_t weak_count_;
 };
@@ -289,7 +511,13 @@ template <>
 class sp_counted_base<false>: checked_thread<false>
 {
 public:
-    sp_counted_base():
+    using manager_type = sp_manager<false>;
+
+    explicit
+    sp_counted_base(
+        manager_type manager
+    ):
+        manager_(manager),
         use_count_(1),
         weak_count_(1)
     {
@@ -299,24 +527,37 @@ public:
     sp_counted_base(const sp_counted_base&) = delete;
     sp_counted_base& operator=(const sp_counted_base&) = delete;
 
-    virtual
     ~sp_counted_base()
     {
         this->check();
     }
 
-    virtual void dispose() = 0;
+    void
+    dispose()
+    {
+        manager_(this, sp_op::dispose, nullptr);
+    }
 
-    virtual
     void
     destroy()
     {
         this->check();
-        delete this;
+        manager_(this, sp_op::destroy, nullptr);
     }
 
-    virtual void* get_deleter(const std::type_info&) = 0;
-    virtual void* get_untyped_deleter() = 0;
+    void*
+    get_deleter(
+        const std::type_info& ti
+    )
+    {
+        return manager_(this, sp_op::get_deleter, &ti);
+    }
+
+    void*
+    get_untyped_deleter()
+    {
+        return manager_(this, sp_op::get_untyped_deleter, nullptr);
+    }
 
     void
     add_ref_copy()
@@ -371,13 +612,41 @@ public:
     }
 
 private:
+    manager_type manager_;
     long use_count_;
     long weak_count_;
 };
 
+// SP COUNTED MANAGE
+
+// Dispatch an operation to the derived control block.
+template <typename Impl, sp_mode ThreadSafe>
+void*
+sp_counted_manage(
+    sp_counted_base<ThreadSafe>* p,
+    sp_op op,
+    const std::type_info* ti
+)
+{
+    Impl* self = static_cast<Impl*>(p);
+    switch (op) {
+        case sp_op::dispose:
+            self->do_dispose();
+            return nullptr;
+        case sp_op::destroy:
+            self->do_destroy();
+            return nullptr;
+        case sp_op::get_deleter:
+            return self->do_get_deleter(*ti);
+        case sp_op::get_untyped_deleter:
+            return self->do_get_untyped_deleter();
+    }
+    return nullptr;
+}
+
 // SP COUNTED IMPL P
 
-template <typename T, bool ThreadSafe>
+template <typename T, sp_mode ThreadSafe>
 class sp_counted_impl_p: public sp_counted_base<ThreadSafe>
 {
 public:
@@ -385,31 +654,35 @@ public:
     sp_counted_impl_p(
         T * p
     ):
+        sp_counted_base<ThreadSafe>(&sp_counted_manage<sp_counted_impl_p, ThreadSafe>),
         ptr_(p)
     {}
 
     sp_counted_impl_p(sp_counted_impl_p const &) = delete;
     sp_counted_impl_p& operator=(sp_counted_impl_p const &) = delete;
 
-    virtual
     void
-    dispose()
+    do_dispose()
     {
         checked_delete(ptr_);
     }
 
-    virtual
+    void
+    do_destroy()
+    {
+        delete this;
+    }
+
     void*
-    get_deleter(
+    do_get_deleter(
         const std::type_info&
     )
     {
         return nullptr;
     }
 
-    virtual
     void*
-    get_untyped_deleter()
+    do_get_untyped_deleter()
     {
         return nullptr;
     }
@@ -420,7 +693,8 @@ private:
 
 // SP COUNTED IMPL PD
 
-template <typename Pointer, typename Deleter, bool ThreadSafe>
+// The deleter is packed with the pointer, so empty deleters take no space.
+template <typename Pointer, typename Deleter, sp_mode ThreadSafe>
 class sp_counted_impl_pd: public sp_counted_base<ThreadSafe>
 {
 public:
@@ -428,56 +702,60 @@ public:
         Pointer p,
         Deleter& d
     ):
-        ptr_(p),
-        del_(d)
+        sp_counted_base<ThreadSafe>(&sp_counted_manage<sp_counted_impl_pd, ThreadSafe>),
+        data_(p, d)
     {}
 
     sp_counted_impl_pd(
         Pointer p
     ):
-        ptr_(p),
-        del_()
+        sp_counted_base<ThreadSafe>(&sp_counted_manage<sp_counted_impl_pd, ThreadSafe>),
+        data_(p, Deleter())
     {}
 
     sp_counted_impl_pd(sp_counted_impl_pd const &) = delete;
     sp_counted_impl_pd& operator=(sp_counted_impl_pd const &) = delete;
 
-    virtual
     void
-    dispose()
+    do_dispose()
     {
-        del_(ptr_);
+        data_.second()(data_.first());
+    }
+
+    void
+    do_destroy()
+    {
+        delete this;
     }
 
-    virtual
     void*
-    get_deleter(
+    do_get_deleter(
         const std::type_info& ti
     )
     noexcept
     {
         if (typeid(Deleter) == ti) {
-            return &reinterpret_cast<char&>(del_);
+            return &reinterpret_cast<char&>(data_.second());
         }
         return nullptr;
     }
 
-    virtual
     void*
-    get_untyped_deleter()
+    do_get_untyped_deleter()
     noexcept
     {
-        return &reinterpret_cast<char&>(del_);
+        return &reinterpret_cast<char&>(data_.second());
     }
 
 private:
-    Pointer ptr_;
-    Deleter del_;
+    compressed_pair<Pointer, Deleter> data_;
 };
 
 // SP COUNTED IMPL PDA
 
-template <typename Pointer, typename Deleter, typename Allocator, bool ThreadSafe>
+// The deleter and allocator are packed with the pointer, so empty
+// deleters and allocators take no space.
+template <typename Pointer, typename Deleter, typename Allocator, sp_mode ThreadSafe>
 class sp_counted_impl_pda: public sp_counted_base<ThreadSafe>
 {
 public:
@@ -486,75 +764,82 @@ public:
         Deleter& d,
         Allocator alloc
     ):
-        ptr_(p),
-        del_(d),
-        alloc_(alloc)
+        sp_counted_base<ThreadSafe>(&sp_counted_manage<sp_counted_impl_pda, ThreadSafe>),
+        data_(pointer_pair(p, d), alloc)
     {}
 
     sp_counted_impl_pda(
         Pointer p,
         Allocator alloc
     ):
-        ptr_(p),
-        del_(alloc),
-        alloc_(alloc)
+        sp_counted_base<ThreadSafe>(&sp_counted_manage<sp_counted_impl_pda, ThreadSafe>),
+        data_(pointer_pair(p, Deleter(alloc)), alloc)
     {}
 
     sp_counted_impl_pda(const sp_counted_impl_pda&) = delete;
     sp_counted_impl_pda& operator=(const sp_counted_impl_pda&) = delete;
 
-    virtual
     void
-    dispose()
+    do_dispose()
     {
-        del_(ptr_);
+        deleter()(data_.first().first());
     }
 
-    virtual
     void
-    destroy()
+    do_destroy()
     {
         using allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<sp_counted_impl_pda>;
-        allocator alloc(alloc_);
+        allocator alloc(data_.second());
         std::allocator_traits<allocator>::destroy(alloc, this);
         alloc.deallocate(this, 1);
     }
 
-    virtual
     void*
-    get_deleter(
+    do_get_deleter(
         const std::type_info& ti
     )
     noexcept
     {
         if (typeid(Deleter) == ti) {
-            return &reinterpret_cast<char&>(del_);
+            return &reinterpret_cast<char&>(deleter());
         }
         return nullptr;
     }
 
-    virtual
     void*
-    get_untyped_deleter()
+    do_get_untyped_deleter()
     noexcept
     {
-        return &reinterpret_cast<char&>(del_);
+        return &reinterpret_cast<char&>(deleter());
     }
 
 private:
-    Pointer ptr_;
-    Deleter del_;
-    Allocator alloc_;
+    using pointer_pair = compressed_pair<Pointer, Deleter>;
+
+    Deleter&
+    deleter()
+    noexcept
+    {
+        return data_.first().second();
+    }
+
+    compressed_pair<pointer_pair, Allocator> data_;
 };
 
+// SP ADOPT
+
+// Tag to adopt a control block holding a single reference.
+struct sp_adopt_t
+{};
+
 // SHARED COUNT
 
-template <bool ThreadSafe>
+template <sp_mode ThreadSafe>
 class shared_count
 {
 public:
     using count_type = sp_counted_base<ThreadSafe>;
-    static constexpr bool thread_safe = ThreadSafe;
+    static constexpr sp_mode thread_safe = ThreadSafe;
 
     constexpr
     shared_count()
@@ -639,6 +924,14 @@ public:
         r.release();
     }
 
+    shared_count(
+        count_type* pi,
+        sp_adopt_t
+    )
+    noexcept:
+        pi_(pi)
+    {}
+
     shared_count(
         const shared_count& r
     ):
@@ -760,20 +1053,20 @@ public:
     }
 
 private:
-    template <bool> friend class shared_count;
-    template <bool> friend class weak_count;
+    template <sp_mode> friend class shared_count;
+    template <sp_mode> friend class weak_count;
 
     count_type* pi_;
 };
 
 // WEAK COUNT
 
-template <bool ThreadSafe>
+template <sp_mode ThreadSafe>
 class weak_count
 {
 public:
     using count_type = sp_counted_base<ThreadSafe>;
-    static constexpr bool thread_safe = ThreadSafe;
+    static constexpr sp_mode thread_safe = ThreadSafe;
 
     constexpr
     weak_count()
@@ -904,13 +1197,13 @@ public:
     }
 
 private:
-    template <bool> friend class shared_count;
-    template <bool> friend class weak_count;
+    template <sp_mode> friend class shared_count;
+    template <sp_mode> friend class weak_count;
 
     count_type* pi_;
 };
 
-template <bool ThreadSafe>
+template <sp_mode ThreadSafe>
 shared_count<ThreadSafe>::shared_count(
     const weak_count<thread_safe>& r
 ):
@@ -924,11 +1217,11 @@ shared_count<ThreadSafe>::shared_count(
 // SPECIALIZATION
 // --------------
 
-template <bool ThreadSafe>
+template <sp_mode ThreadSafe>
 struct is_relocatable<shared_count<ThreadSafe>>: std::true_type
 {};
 
-template <bool ThreadSafe>
+template <sp_mode ThreadSafe>
 struct is_relocatable<weak_count<ThreadSafe>>: std::true_type
 {};
 
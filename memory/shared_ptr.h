@@ -7,7 +7,7 @@
  *  \brief `shared_ptr` with single-threaded optimizations.
  *
  *  \synopsis
- *      template <typename T, bool ThreadSafe>
+ *      template <typename T, sp_mode ThreadSafe>
  *      class enable_shared_from_this
  *      {
  *      protected:
@@ -17,7 +17,7 @@
  *          ~enable_shared_from_this() noexcept;
  *
  *      public:
- *          static constexpr bool thread_safe = ThreadSafe;
+ *          static constexpr sp_mode thread_safe = ThreadSafe;
  *
  *          shared_ptr<T, thread_safe> shared_from_this();
  *          shared_ptr<const T, thread_safe> shared_from_this() const;
@@ -25,14 +25,14 @@
  *          weak_ptr<const T, thread_safe> weak_from_this() const noexcept;
  *      };
  *
- *      template <typename T, bool ThreadSafe>
+ *      template <typename T, sp_mode ThreadSafe>
  *      class shared_ptr
  *      {
  *      public:
  *          using element_type = typename std::remove_extent<T>::type;
  *          using weak_type = weak_ptr<T, ThreadSafe>;
  *          using count_type = shared_count<ThreadSafe>;
- *          static constexpr bool thread_safe = ThreadSafe;
+ *          static constexpr sp_mode thread_safe = ThreadSafe;
  *
  *          constexpr shared_ptr() noexcept;
  *          constexpr shared_ptr(std::nullptr_t) noexcept;
@@ -108,17 +108,34 @@
  *          bool owner_before(const weak_ptr<U, thread_safe>& r) const noexcept;
  *      };
  *
- *      template <typename T, bool ThreadSafe, typename ... Ts>
+ *      template <typename T, sp_mode ThreadSafe, typename ... Ts>
  *      shared_ptr<T, ThreadSafe> make_shared(Ts&&... ts);
  *
  *      template <typename T, typename ... Ts>
  *      shared_ptr<T, true> make_shared(Ts&&... ts);
  *
- *      template <typename T, bool ThreadSafe, typename Allocator, typename ... Ts>
+ *      template <typename T, sp_mode ThreadSafe, typename Allocator, typename ... Ts>
  *      shared_ptr<T, ThreadSafe> allocate_shared(const Allocator& alloc, Ts&&... ts);
  *
  *      template <typename T, typename Allocator, typename ... Ts>
  *      shared_ptr<T, true> allocate_shared(const Allocator& alloc, Ts&&... ts);
+ *
+ *      // Arrays, with the elements and control block in one allocation.
+ *      template <typename T, sp_mode ThreadSafe = true>
+ *      shared_ptr<T, ThreadSafe> make_shared(size_t n);                     // T[]
+ *      shared_ptr<T, ThreadSafe> make_shared(size_t n, const U& u);         // T[]
+ *      shared_ptr<T, ThreadSafe> make_shared();                             // T[N]
+ *      shared_ptr<T, ThreadSafe> make_shared(const U& u);                   // T[N]
+ *      shared_ptr<T, ThreadSafe> make_shared_for_overwrite(size_t n);       // T[]
+ *      shared_ptr<T, ThreadSafe> make_shared_for_overwrite();               // T[N]
+ *
+ *      template <typename T, sp_mode ThreadSafe = true, typename Allocator>
+ *      shared_ptr<T, ThreadSafe> allocate_shared(const Allocator& alloc, size_t n);
+ *      shared_ptr<T, ThreadSafe> allocate_shared(const Allocator& alloc, size_t n, const U& u);
+ *      shared_ptr<T, ThreadSafe> allocate_shared(const Allocator& alloc);
+ *      shared_ptr<T, ThreadSafe> allocate_shared(const Allocator& alloc, const U& u);
+ *      shared_ptr<T, ThreadSafe> allocate_shared_for_overwrite(const Allocator& alloc, size_t n);
+ *      shared_ptr<T, ThreadSafe> allocate_shared_for_overwrite(const Allocator& alloc);
  */
 
 #pragma once
@@ -127,6 +144,8 @@
 #include <pycpp/stl/memory/make_shared.h>
 #include <pycpp/stl/type_traits/is_array.h>
 #include <cassert>
+#include <limits>
+#include <new>
 
 PYCPP_BEGIN_NAMESPACE
 
@@ -135,7 +154,7 @@ PYCPP_BEGIN_NAMESPACE
 
 // SP ENABLE SHARED FROM THIS
 
-template <typename X, typename Y, typename T, bool ThreadSafe>
+template <typename X, typename Y, typename T, sp_mode ThreadSafe>
 inline
 void
 sp_enable_shared_from_this(
@@ -183,7 +202,7 @@ noexcept
 
 // SP POINTER CONSTRUCT
 
-template <typename T, typename U, bool ThreadSafe>
+template <typename T, typename U, sp_mode ThreadSafe>
 inline
 void
 sp_pointer_construct(
@@ -197,7 +216,7 @@ noexcept
     sp_enable_shared_from_this(sp, p, p);
 }
 
-template <typename T, typename U, bool ThreadSafe>
+template <typename T, typename U, sp_mode ThreadSafe>
 inline
 void
 sp_pointer_construct(
@@ -216,7 +235,7 @@ noexcept
     shared_count<ThreadSafe>(p, deleter()).swap(count);
 }
 
-template <typename T, size_t N, typename U, bool ThreadSafe>
+template <typename T, size_t N, typename U, sp_mode ThreadSafe>
 inline void sp_pointer_construct(
     shared_ptr<T[N], ThreadSafe>*,
     U* p,
@@ -235,7 +254,7 @@ noexcept
 
 // SP DELETER CONTRUCT
 
-template <typename T, typename U, bool ThreadSafe>
+template <typename T, typename U, sp_mode ThreadSafe>
 inline
 void
 sp_deleter_construct(
@@ -248,7 +267,7 @@ noexcept
 }
 
 
-template <typename T, typename U, bool ThreadSafe>
+template <typename T, typename U, sp_mode ThreadSafe>
 inline
 void
 sp_deleter_construct(
@@ -262,7 +281,7 @@ sp_deleter_construct(
     );
 }
 
-template <typename T, size_t N, typename U, bool ThreadSafe>
+template <typename T, size_t N, typename U, sp_mode ThreadSafe>
 inline
 void
 sp_deleter_construct(
@@ -282,7 +301,7 @@ noexcept
 
 // ENABLE SHARED FROM THIS
 
-template <typename T, bool ThreadSafe>
+template <typename T, sp_mode ThreadSafe>
 class enable_shared_from_this
 {
 protected:
@@ -314,7 +333,7 @@ protected:
     {}
 
 public:
-    static constexpr bool thread_safe = ThreadSafe;
+    static constexpr sp_mode thread_safe = ThreadSafe;
 
     shared_ptr<T, thread_safe>
     shared_from_this()
@@ -372,7 +391,7 @@ private:
     }
 };
 
-template <typename X, typename Y, typename T, bool ThreadSafe>
+template <typename X, typename Y, typename T, sp_mode ThreadSafe>
 inline
 void
 sp_enable_shared_from_this(
@@ -408,49 +427,17 @@ using sp_enable_if_unbounded_array_t = typename std::enable_if<
     is_unbounded_array<T>::value, R
 >::type;
 
-template <typename T, bool ThreadSafe, typename ... Ts>
+template <typename T, sp_mode ThreadSafe, typename ... Ts>
 sp_disable_if_array_t<T, shared_ptr<T, ThreadSafe>>
 make_shared(Ts&&... ts);
 
-// TODO(ahuszagh): Wish list
-//template <typename T, bool ThreadSafe>
-//sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
-//make_shared();
-//
-//template <typename T, bool ThreadSafe>
-//sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
-//make_shared(const typename std::remove_extent<T>::type& u);
-//
-//template <typename T, bool ThreadSafe>
-//sp_enable_if_array_t<T, shared_ptr<T, ThreadSafe>>
-//make_shared(std::size_t n);
-//
-//template <typename T, bool ThreadSafe>
-//sp_enable_if_array_t<T, shared_ptr<T, ThreadSafe>>
-//make_shared(std::size_t n, const typename std::remove_extent<T>::type& u);
-
-template <typename T, bool ThreadSafe, typename Allocator, typename ... Ts>
+template <typename T, sp_mode ThreadSafe, typename Allocator, typename ... Ts>
 sp_disable_if_array_t<T, shared_ptr<T, ThreadSafe>>
 allocate_shared(const Allocator& alloc, Ts&&... ts);
 
-// TODO(ahuszagh): Wish list
-//template <typename T, bool ThreadSafe, typename Allocator>
-//sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
-//allocate_shared(const Allocator& alloc);
-//
-//template <typename T, bool ThreadSafe, typename Allocator>
-//sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
-//allocate_shared(const Allocator& alloc, const typename std::remove_extent<T>::type& u);
-//template <typename T, bool ThreadSafe, typename Allocator>
-//sp_enable_if_array_t<T, shared_ptr<T, ThreadSafe>>
-//allocate_shared(const Allocator& alloc, std::size_t n);
-//
-//template <typename T, bool ThreadSafe, typename Allocator>
-//sp_enable_if_array_t<T, shared_ptr<T, ThreadSafe>>
-//allocate_shared(const Allocator& alloc, std::size_t n, const typename std::remove_extent<T>::type& u);
-
-
-template <typename T, bool ThreadSafe>
+struct sp_make_access;
+
+template <typename T, sp_mode ThreadSafe>
 class shared_ptr
 {
 public:
@@ -459,7 +446,7 @@ public:
     using element_type = typename std::remove_extent<T>::type;
     using weak_type = weak_ptr<T, ThreadSafe>;
     using count_type = shared_count<ThreadSafe>;
-    static constexpr bool thread_safe = ThreadSafe;
+    static constexpr sp_mode thread_safe = ThreadSafe;
 
     // MEMBER FUNCTIONS
     // ----------------
@@ -560,7 +547,7 @@ public:
         ctrl_(r.ctrl_)
     {
         static_assert(
-            std::is_convertible<U, T>::value,
+            std::is_convertible<U*, T*>::value,
             "U must be convertible to T."
         );
     }
@@ -585,7 +572,7 @@ public:
         ctrl_()
     {
         static_assert(
-            std::is_convertible<U, T>::value,
+            std::is_convertible<U*, T*>::value,
             "U must be convertible to T."
         );
 
@@ -601,7 +588,7 @@ public:
         ptr_(r.ptr_)
     {
         static_assert(
-            std::is_convertible<U, T>::value,
+            std::is_convertible<U*, T*>::value,
             "U must be convertible to T."
         );
 
@@ -617,7 +604,7 @@ public:
         ctrl_()
     {
         static_assert(
-            std::is_convertible<U, T>::value,
+            std::is_convertible<U*, T*>::value,
             "U must be convertible to T."
         );
 
@@ -813,8 +800,8 @@ private:
     count_type ctrl_;
 
     // Friends
-    template <typename, bool> friend class weak_ptr;
-    template <typename, bool> friend class shared_ptr;
+    template <typename, sp_mode> friend class weak_ptr;
+    template <typename, sp_mode> friend class shared_ptr;
 
     template <typename U, bool Threaded, typename ... Ts>
     friend sp_disable_if_array_t<U, shared_ptr<U, Threaded>> make_shared(Ts&&...);
@@ -822,6 +809,18 @@ private:
     template <typename U, bool Threaded, typename Allocator, typename ... Ts>
     friend sp_disable_if_array_t<U, shared_ptr<U, Threaded>> allocate_shared(const Allocator&, Ts&&...);
 
+    friend struct sp_make_access;
+
+    // Adopt a control block, for the array factories.
+    shared_ptr(
+        element_type* p,
+        count_type&& ctrl
+    )
+    noexcept:
+        ptr_(p),
+        ctrl_(std::move(ctrl))
+    {}
+
     // Internal
     void*
     get_deleter(
@@ -840,9 +839,119 @@ private:
     }
 };
 
+// SP MAKE ACCESS
+
+// Allocator for the elements of arrays from `make_shared`.
+template <typename T>
+using sp_array_allocator = allocator<typename std::remove_all_extents<T>::type>;
+
+// Factories for objects and arrays sharing a single allocation with
+// their control block. Multidimensional arrays are stored as a flat
+// array of their innermost elements.
+struct sp_make_access
+{
+    template <typename T, sp_mode ThreadSafe, typename Allocator, typename ... Ts>
+    static
+    shared_ptr<T, ThreadSafe>
+    make_inplace(
+        const Allocator& alloc,
+        Ts&&... ts
+    )
+    {
+        using impl_type = sp_counted_impl_inplace<T, Allocator, ThreadSafe>;
+
+        impl_type* pi = impl_type::create(alloc, std::forward<Ts>(ts)...);
+        T* p = pi->get();
+        shared_ptr<T, ThreadSafe> ptr = adopt<T, ThreadSafe>(pi, p);
+        sp_enable_shared_from_this(&ptr, p, p);
+
+        return ptr;
+    }
+
+    template <typename T, sp_mode ThreadSafe, typename Allocator>
+    static
+    shared_ptr<T, ThreadSafe>
+    make(
+        const Allocator& alloc,
+        size_t n,
+        const typename std::remove_extent<T>::type* u
+    )
+    {
+        using element_type = typename std::remove_extent<T>::type;
+        using value_type = typename std::remove_all_extents<T>::type;
+        using impl_type = sp_counted_impl_array<value_type, Allocator, ThreadSafe>;
+
+        constexpr size_t m = sizeof(element_type) / sizeof(value_type);
+        size_t count = size<T>(n);
+        impl_type* pi = impl_type::create(alloc, count);
+        try {
+            pi->construct(count, reinterpret_cast<const value_type*>(u), m);
+        } catch (...) {
+            pi->destroy();
+            throw;
+        }
+        return adopt<T, ThreadSafe>(pi, reinterpret_cast<element_type*>(pi->data()));
+    }
+
+    template <typename T, sp_mode ThreadSafe, typename Allocator>
+    static
+    shared_ptr<T, ThreadSafe>
+    make_default(
+        const Allocator& alloc,
+        size_t n
+    )
+    {
+        using element_type = typename std::remove_extent<T>::type;
+        using value_type = typename std::remove_all_extents<T>::type;
+        using impl_type = sp_counted_impl_array<value_type, Allocator, ThreadSafe>;
+
+        size_t count = size<T>(n);
+        impl_type* pi = impl_type::create(alloc, count);
+        try {
+            pi->construct_default(count);
+        } catch (...) {
+            pi->destroy();
+            throw;
+        }
+        return adopt<T, ThreadSafe>(pi, reinterpret_cast<element_type*>(pi->data()));
+    }
+
+private:
+    // Number of innermost elements in `n` elements of `T`.
+    template <typename T>
+    static
+    size_t
+    size(
+        size_t n
+    )
+    {
+        using element_type = typename std::remove_extent<T>::type;
+        using value_type = typename std::remove_all_extents<T>::type;
+        constexpr size_t m = sizeof(element_type) / sizeof(value_type);
+
+        if (n > std::numeric_limits<size_t>::max() / m) {
+            throw std::bad_alloc();
+        }
+        return n * m;
+    }
+
+    template <typename T, sp_mode ThreadSafe, typename Impl>
+    static
+    shared_ptr<T, ThreadSafe>
+    adopt(
+        Impl* pi,
+        typename std::remove_extent<T>::type* p
+    )
+    noexcept
+    {
+        using count_type = shared_count<ThreadSafe>;
+        return shared_ptr<T, ThreadSafe>(p, count_type(static_cast<typename count_type::count_type*>(pi), sp_adopt_t()));
+    }
+};
+
 // MAKE SHARED
 
-template <typename T, bool ThreadSafe, typename ... Ts>
+template <typename T, sp_mode ThreadSafe, typename ... Ts>
 inline
 sp_disable_if_array_t<T, shared_ptr<T, ThreadSafe>>
 make_shared(
@@ -851,22 +960,7 @@ make_shared(
 {
     static_assert(std::is_constructible<T, Ts...>::value, "Can't construct object in make_shared");
 
-    using allocator_type = allocator<T>;
-    using shared_type = shared_ptr<T, ThreadSafe>;
-    using deleter_type = sp_ms_deleter<T>;
-
-    // allocate control and data
-    shared_type ptr(static_cast<T*>(nullptr), deleter_type());
-    auto* pd = static_cast<deleter_type*>(ptr.get_untyped_deleter());
-    void* pv = pd->address();
-    new (pv) T(std::forward<Ts>(ts)...);
-
-    // initialize and create shared
-    pd->set_initialized();
-    T* ptr2 = static_cast<T*>(pv);
-    sp_enable_shared_from_this(&ptr, ptr2, ptr2);
-
-    return shared_type(ptr, ptr2);
+    return sp_make_access::make_inplace<T, ThreadSafe>(allocator<T>(), std::forward<Ts>(ts)...);
 }
 
 template <typename T, typename ... Ts>
@@ -879,27 +973,137 @@ make_shared(
     return make_shared<T, PYCPP_SP_THREAD_SAFE>(std::forward<Ts>(ts)...);
 }
 
-// TODO: need all make_shared
-
-//template <typename T, bool ThreadSafe>
-//sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
-//make_shared();
-//
-//template <typename T, bool ThreadSafe>
-//sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
-//make_shared(const typename std::remove_extent<T>::type& u);
-//
-//template <typename T, bool ThreadSafe>
-//sp_enable_if_array_t<T, shared_ptr<T, ThreadSafe>>
-//make_shared(std::size_t n);
-//
-//template <typename T, bool ThreadSafe>
-//sp_enable_if_array_t<T, shared_ptr<T, ThreadSafe>>
-//make_shared(std::size_t n, const typename std::remove_extent<T>::type& u);
+// MAKE SHARED ARRAY
+
+template <typename T, sp_mode ThreadSafe>
+inline
+sp_enable_if_unbounded_array_t<T, shared_ptr<T, ThreadSafe>>
+make_shared(
+    size_t n
+)
+{
+    return sp_make_access::make<T, ThreadSafe>(sp_array_allocator<T>(), n, nullptr);
+}
+
+
+template <typename T>
+inline
+sp_enable_if_unbounded_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+make_shared(
+    size_t n
+)
+{
+    return make_shared<T, PYCPP_SP_THREAD_SAFE>(n);
+}
+
+
+template <typename T, sp_mode ThreadSafe>
+inline
+sp_enable_if_unbounded_array_t<T, shared_ptr<T, ThreadSafe>>
+make_shared(
+    size_t n,
+    const typename std::remove_extent<T>::type& u
+)
+{
+    return sp_make_access::make<T, ThreadSafe>(sp_array_allocator<T>(), n, &u);
+}
+
+
+template <typename T>
+inline
+sp_enable_if_unbounded_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+make_shared(
+    size_t n,
+    const typename std::remove_extent<T>::type& u
+)
+{
+    return make_shared<T, PYCPP_SP_THREAD_SAFE>(n, u);
+}
+
+
+template <typename T, sp_mode ThreadSafe>
+inline
+sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
+make_shared()
+{
+    return sp_make_access::make<T, ThreadSafe>(sp_array_allocator<T>(), std::extent<T>::value, nullptr);
+}
+
+
+template <typename T>
+inline
+sp_enable_if_bounded_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+make_shared()
+{
+    return make_shared<T, PYCPP_SP_THREAD_SAFE>();
+}
+
+
+template <typename T, sp_mode ThreadSafe>
+inline
+sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
+make_shared(
+    const typename std::remove_extent<T>::type& u
+)
+{
+    return sp_make_access::make<T, ThreadSafe>(sp_array_allocator<T>(), std::extent<T>::value, &u);
+}
+
+
+template <typename T>
+inline
+sp_enable_if_bounded_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+make_shared(
+    const typename std::remove_extent<T>::type& u
+)
+{
+    return make_shared<T, PYCPP_SP_THREAD_SAFE>(u);
+}
+
+// MAKE SHARED FOR OVERWRITE
+
+template <typename T, sp_mode ThreadSafe>
+inline
+sp_enable_if_unbounded_array_t<T, shared_ptr<T, ThreadSafe>>
+make_shared_for_overwrite(
+    size_t n
+)
+{
+    return sp_make_access::make_default<T, ThreadSafe>(sp_array_allocator<T>(), n);
+}
+
+
+template <typename T>
+inline
+sp_enable_if_unbounded_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+make_shared_for_overwrite(
+    size_t n
+)
+{
+    return make_shared_for_overwrite<T, PYCPP_SP_THREAD_SAFE>(n);
+}
+
+
+template <typename T, sp_mode ThreadSafe>
+inline
+sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
+make_shared_for_overwrite()
+{
+    return sp_make_access::make_default<T, ThreadSafe>(sp_array_allocator<T>(), std::extent<T>::value);
+}
+
+
+template <typename T>
+inline
+sp_enable_if_bounded_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+make_shared_for_overwrite()
+{
+    return make_shared_for_overwrite<T, PYCPP_SP_THREAD_SAFE>();
+}
 
 // ALLOCATE SHARED
 
-template <typename T, bool ThreadSafe, typename Allocator, typename ... Ts>
+template <typename T, sp_mode ThreadSafe, typename Allocator, typename ... Ts>
 inline
 sp_disable_if_array_t<T, shared_ptr<T, ThreadSafe>>
 allocate_shared(
@@ -909,25 +1113,7 @@ allocate_shared(
 {
     static_assert(std::is_constructible<T, Ts...>::value, "Can't construct object in make_shared");
 
-    using element_type = T;
-    using allocator_type = Allocator;
-    using alloc_traits = allocator_traits<allocator_type>;
-    using shared_type = shared_ptr<element_type, ThreadSafe>;
-    using deleter_type = sp_as_deleter<element_type, allocator_type>;
-
-    // allocate control and data
-    allocator_type a(alloc);
-    shared_type ptr(static_cast<T*>(nullptr), deleter_type(a), a);
-    auto* pd = static_cast<deleter_type*>(ptr.get_untyped_deleter());
-    void* pv = pd->address();
-    alloc_traits::construct(a, static_cast<T*>(pv), std::forward<Ts>(ts)...);
-
-    // initialize and create shared
-    pd->set_initialized();
-    T* ptr2 = static_cast<T*>(pv);
-    sp_enable_shared_from_this(&ptr, ptr2, ptr2);
-
-    return shared_type(ptr, ptr2);
+    return sp_make_access::make_inplace<T, ThreadSafe>(alloc, std::forward<Ts>(ts)...);
 }
 
 template <typename T, typename Allocator, typename ... Ts>
@@ -941,49 +1127,160 @@ allocate_shared(
     return allocate_shared<T, PYCPP_SP_THREAD_SAFE>(alloc, std::forward<Ts>(ts)...);
 }
 
-// TODO: need all allocate_shared
-
-//template <typename T, bool ThreadSafe, typename Allocator>
-//sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
-//allocate_shared(const Allocator& alloc)
-//
-//template <typename T, bool ThreadSafe, typename Allocator>
-//sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
-//allocate_shared(const Allocator& alloc, const typename std::remove_extent<T>::type& u);
-//template <typename T, bool ThreadSafe, typename Allocator>
-//sp_enable_if_array_t<T, shared_ptr<T, ThreadSafe>>
-//allocate_shared(const Allocator& alloc, std::size_t n);
-//
-//template <typename T, bool ThreadSafe, typename Allocator>
-//sp_enable_if_array_t<T, shared_ptr<T, ThreadSafe>>
-//allocate_shared(const Allocator& alloc, std::size_t n, const typename std::remove_extent<T>::type& u);
-
-// Tentative implementation of #1
-//template <typename T, bool ThreadSafe, typename Allocator>
-//inline
-//sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
-//allocate_shared(
-//    const Allocator& alloc
-//)
-//{
-//    constexpr size_t size = std::extent<T, 0>::value;
-//    using axis_type = typename std::remove_extent<T>::type;
-//    using value_type = typename std::remove_all_extents<T>::type;
-//    using allocator_type = typename allocator_traits<Allocator>::template rebind_alloc<value_type> type;
-//    // TODO: do I need state?
-//    // sp_array_scalar is remove_all_extents
-//}
+// ALLOCATE SHARED ARRAY
+
+template <typename T, sp_mode ThreadSafe, typename Allocator>
+inline
+sp_enable_if_unbounded_array_t<T, shared_ptr<T, ThreadSafe>>
+allocate_shared(
+    const Allocator& alloc,
+    size_t n
+)
+{
+    return sp_make_access::make<T, ThreadSafe>(alloc, n, nullptr);
+}
+
+
+template <typename T, typename Allocator>
+inline
+sp_enable_if_unbounded_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+allocate_shared(
+    const Allocator& alloc,
+    size_t n
+)
+{
+    return allocate_shared<T, PYCPP_SP_THREAD_SAFE>(alloc, n);
+}
+
+
+template <typename T, sp_mode ThreadSafe, typename Allocator>
+inline
+sp_enable_if_unbounded_array_t<T, shared_ptr<T, ThreadSafe>>
+allocate_shared(
+    const Allocator& alloc,
+    size_t n,
+    const typename std::remove_extent<T>::type& u
+)
+{
+    return sp_make_access::make<T, ThreadSafe>(alloc, n, &u);
+}
+
+
+template <typename T, typename Allocator>
+inline
+sp_enable_if_unbounded_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+allocate_shared(
+    const Allocator& alloc,
+    size_t n,
+    const typename std::remove_extent<T>::type& u
+)
+{
+    return allocate_shared<T, PYCPP_SP_THREAD_SAFE>(alloc, n, u);
+}
+
+
+template <typename T, sp_mode ThreadSafe, typename Allocator>
+inline
+sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
+allocate_shared(
+    const Allocator& alloc
+)
+{
+    return sp_make_access::make<T, ThreadSafe>(alloc, std::extent<T>::value, nullptr);
+}
+
+
+template <typename T, typename Allocator>
+inline
+sp_enable_if_bounded_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+allocate_shared(
+    const Allocator& alloc
+)
+{
+    return allocate_shared<T, PYCPP_SP_THREAD_SAFE>(alloc);
+}
+
+
+template <typename T, sp_mode ThreadSafe, typename Allocator>
+inline
+sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
+allocate_shared(
+    const Allocator& alloc,
+    const typename std::remove_extent<T>::type& u
+)
+{
+    return sp_make_access::make<T, ThreadSafe>(alloc, std::extent<T>::value, &u);
+}
+
+
+template <typename T, typename Allocator>
+inline
+sp_enable_if_bounded_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+allocate_shared(
+    const Allocator& alloc,
+    const typename std::remove_extent<T>::type& u
+)
+{
+    return allocate_shared<T, PYCPP_SP_THREAD_SAFE>(alloc, u);
+}
+
+// ALLOCATE SHARED FOR OVERWRITE
+
+template <typename T, sp_mode ThreadSafe, typename Allocator>
+inline
+sp_enable_if_unbounded_array_t<T, shared_ptr<T, ThreadSafe>>
+allocate_shared_for_overwrite(
+    const Allocator& alloc,
+    size_t n
+)
+{
+    return sp_make_access::make_default<T, ThreadSafe>(alloc, n);
+}
+
+
+template <typename T, typename Allocator>
+inline
+sp_enable_if_unbounded_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+allocate_shared_for_overwrite(
+    const Allocator& alloc,
+    size_t n
+)
+{
+    return allocate_shared_for_overwrite<T, PYCPP_SP_THREAD_SAFE>(alloc, n);
+}
+
+
+template <typename T, sp_mode ThreadSafe, typename Allocator>
+inline
+sp_enable_if_bounded_array_t<T, shared_ptr<T, ThreadSafe>>
+allocate_shared_for_overwrite(
+    const Allocator& alloc
+)
+{
+    return sp_make_access::make_default<T, ThreadSafe>(alloc, std::extent<T>::value);
+}
+
+
+template <typename T, typename Allocator>
+inline
+sp_enable_if_bounded_array_t<T, shared_ptr<T, PYCPP_SP_THREAD_SAFE>>
+allocate_shared_for_overwrite(
+    const Allocator& alloc
+)
+{
+    return allocate_shared_for_overwrite<T, PYCPP_SP_THREAD_SAFE>(alloc);
+}
 
 // TODO: implement swap
 
 // SPECIALIZATION
 // --------------
 
-template <typename T, bool ThreadSafe>
+template <typename T, sp_mode ThreadSafe>
 struct is_relocatable<enable_shared_from_this<T, ThreadSafe>>: is_relocatable<weak_ptr<T, ThreadSafe>>
 {};
 
-template <typename T, bool ThreadSafe>
+template <typename T, sp_mode ThreadSafe>
 struct is_relocatable<shared_ptr<T, ThreadSafe>>: is_relocatable<shared_count<ThreadSafe>>
 {};
 
@@ -0,0 +1,275 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/stl/cstdlib/aligned_alloc.h>
+#include <pycpp/stl/memory/size_class.h>
+#include <mutex>
+#include <new>
+
+PYCPP_BEGIN_NAMESPACE
+
+// MACROS
+// ------
+
+// Blocks a thread may cache per class before returning them.
+#ifndef PYCPP_SIZE_CLASS_CACHE
+#   define PYCPP_SIZE_CLASS_CACHE 256
+#endif
+
+// Blocks a thread takes from the global list at once.
+#ifndef PYCPP_SIZE_CLASS_BATCH
+#   define PYCPP_SIZE_CLASS_BATCH (PYCPP_SIZE_CLASS_CACHE / 2)
+#endif
+
+// OBJECTS
+// -------
+
+static constexpr size_t SIZE_CLASS_COUNT = SIZE_CLASS_MAX / SIZE_CLASS_ALIGNMENT;
+
+struct free_block
+{
+    free_block* next;
+};
+
+// Global free lists, one per class. Threads only take a bounded batch
+// at a time, so no thread hoards the blocks freed by others.
+struct global_list
+{
+    free_block* head;
+    size_t count;
+};
+
+static global_list global_lists[SIZE_CLASS_COUNT];
+
+// Thread-local free lists. Trivially destructible, so it remains
+// accessible during thread shutdown, after the flusher has run.
+struct thread_cache
+{
+    free_block* heads[SIZE_CLASS_COUNT];
+    size_t counts[SIZE_CLASS_COUNT];
+    bool dead;
+};
+
+static thread_local thread_cache cache;
+
+// HELPERS
+// -------
+
+static
+size_t
+class_index(
+    size_t n
+)
+noexcept
+{
+    return size_class_round(n) / SIZE_CLASS_ALIGNMENT - 1;
+}
+
+
+// The locks are leaked, so they remain valid for threads exiting
+// during static destruction.
+static
+std::mutex&
+global_lock(
+    size_t index
+)
+{
+    static std::mutex* locks = new std::mutex[SIZE_CLASS_COUNT];
+    return locks[index];
+}
+
+
+static
+void
+push_list(
+    size_t index,
+    free_block* first,
+    free_block* last,
+    size_t count
+)
+noexcept
+{
+    std::lock_guard<std::mutex> lock(global_lock(index));
+    global_list& list = global_lists[index];
+    last->next = list.head;
+    list.head = first;
+    list.count += count;
+}
+
+
+// Take up to `PYCPP_SIZE_CLASS_BATCH` blocks from the global list,
+// returning the number of blocks taken.
+static
+size_t
+pop_batch(
+    size_t index,
+    free_block*& first
+)
+noexcept
+{
+    std::lock_guard<std::mutex> lock(global_lock(index));
+    global_list& list = global_lists[index];
+    first = list.head;
+    if (list.count <= PYCPP_SIZE_CLASS_BATCH) {
+        size_t count = list.count;
+        list.head = nullptr;
+        list.count = 0;
+        return count;
+    }
+
+    free_block* last = first;
+    for (size_t i = 1; i < PYCPP_SIZE_CLASS_BATCH; ++i) {
+        last = last->next;
+    }
+    list.head = last->next;
+    list.count -= PYCPP_SIZE_CLASS_BATCH;
+    last->next = nullptr;
+    return PYCPP_SIZE_CLASS_BATCH;
+}
+
+
+// Return all but the `keep` most recently freed blocks in a class
+// to the global list.
+static
+void
+flush_class(
+    size_t index,
+    size_t keep
+)
+noexcept
+{
+    if (cache.counts[index] <= keep) {
+        return;
+    }
+
+    free_block** link = &cache.heads[index];
+    for (size_t i = 0; i < keep; ++i) {
+        link = &(*link)->next;
+    }
+    free_block* first = *link;
+    free_block* last = first;
+    while (last->next) {
+        last = last->next;
+    }
+    push_list(index, first, last, cache.counts[index] - keep);
+    *link = nullptr;
+    cache.counts[index] = keep;
+}
+
+
+// Flushes the thread cache to the global lists on thread exit.
+struct thread_cache_flusher
+{
+    ~thread_cache_flusher()
+    {
+        for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i) {
+            flush_class(i, 0);
+        }
+        cache.dead = true;
+    }
+};
+
+static thread_local thread_cache_flusher flusher;
+
+
+// Touch the flusher so it is constructed, and runs on thread exit.
+static
+void
+register_flusher()
+noexcept
+{
+    static_cast<void>(&flusher);
+}
+
+
+// Carve a new chunk into a cache's worth of blocks for a class.
+static
+free_block*
+allocate_chunk(
+    size_t index
+)
+{
+    size_t size = (index + 1) * SIZE_CLASS_ALIGNMENT;
+    size_t count = PYCPP_SIZE_CLASS_CACHE;
+    char* chunk = static_cast<char*>(aligned_alloc(SIZE_CLASS_ALIGNMENT, count * size));
+    if (chunk == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    free_block* first = reinterpret_cast<free_block*>(chunk);
+    free_block* block = first;
+    for (size_t i = 1; i < count; ++i) {
+        free_block* next = reinterpret_cast<free_block*>(chunk + i * size);
+        block->next = next;
+        block = next;
+    }
+    block->next = nullptr;
+
+    return first;
+}
+
+// FUNCTIONS
+// ---------
+
+void*
+size_class_allocate(
+    size_t n
+)
+{
+    size_t index = class_index(n);
+    free_block* block = cache.heads[index];
+    if (block) {
+        cache.heads[index] = block->next;
+        --cache.counts[index];
+        return block;
+    }
+
+    // refill from the global list, or a new chunk
+    size_t count = pop_batch(index, block);
+    if (block == nullptr) {
+        block = allocate_chunk(index);
+        count = PYCPP_SIZE_CLASS_CACHE;
+    }
+
+    if (cache.dead) {
+        // thread is exiting, return the remainder immediately
+        if (block->next) {
+            free_block* last = block->next;
+            while (last->next) {
+                last = last->next;
+            }
+            push_list(index, block->next, last, count - 1);
+        }
+    } else {
+        register_flusher();
+        cache.heads[index] = block->next;
+        cache.counts[index] = count - 1;
+    }
+
+    return block;
+}
+
+
+void
+size_class_deallocate(
+    void* p,
+    size_t n
+)
+noexcept
+{
+    size_t index = class_index(n);
+    free_block* block = static_cast<free_block*>(p);
+    if (cache.dead) {
+        push_list(index, block, block, 1);
+        return;
+    }
+
+    register_flusher();
+    block->next = cache.heads[index];
+    cache.heads[index] = block;
+    if (++cache.counts[index] > PYCPP_SIZE_CLASS_CACHE) {
+        flush_class(index, PYCPP_SIZE_CLASS_CACHE / 2);
+    }
+}
+
+PYCPP_END_NAMESPACE
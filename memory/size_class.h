@@ -0,0 +1,96 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Lock-free free lists for small, fixed-size allocations.
+ *
+ *  Small requests are rounded up to a size class, a multiple of the
+ *  fundamental alignment, and served from a thread-local free list for
+ *  that class. Threads exchange surplus blocks through a global list
+ *  per class, guarded by a mutex, and only in bounded batches, so a
+ *  refill neither takes every block freed by other threads nor walks
+ *  the whole list. Blocks are carved from large chunks, which are
+ *  retained for the lifetime of the process.
+ *
+ *  \synopsis
+ *      static constexpr size_t SIZE_CLASS_ALIGNMENT = implementation-defined;
+ *      static constexpr size_t SIZE_CLASS_MAX = implementation-defined;
+ *
+ *      constexpr bool is_size_class(size_t n, size_t alignment) noexcept;
+ *      constexpr size_t size_class_round(size_t n) noexcept;
+ *      void* size_class_allocate(size_t n);
+ *      void size_class_deallocate(void* p, size_t n) noexcept;
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+#include <cstddef>
+
+PYCPP_BEGIN_NAMESPACE
+
+// MACROS
+// ------
+
+// Largest request, in bytes, served from the size-class free lists.
+#ifndef PYCPP_SIZE_CLASS_MAX
+#   define PYCPP_SIZE_CLASS_MAX 256
+#endif
+
+// OBJECTS
+// -------
+
+static constexpr size_t SIZE_CLASS_ALIGNMENT = alignof(std::max_align_t);
+static constexpr size_t SIZE_CLASS_MAX = PYCPP_SIZE_CLASS_MAX;
+
+static_assert(SIZE_CLASS_MAX % SIZE_CLASS_ALIGNMENT == 0, "Size classes must be a multiple of the alignment.");
+
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief Check if a request is served by the size-class free lists.
+ */
+inline constexpr
+bool
+is_size_class(
+    size_t n,
+    size_t alignment
+)
+noexcept
+{
+    return n <= SIZE_CLASS_MAX && alignment <= SIZE_CLASS_ALIGNMENT;
+}
+
+/**
+ *  \brief Round a small request up to the size of its class.
+ */
+inline constexpr
+size_t
+size_class_round(
+    size_t n
+)
+noexcept
+{
+    return n == 0 ? SIZE_CLASS_ALIGNMENT : (n + SIZE_CLASS_ALIGNMENT - 1) & ~(SIZE_CLASS_ALIGNMENT - 1);
+}
+
+/**
+ *  \brief Allocate a block of at least `n <= SIZE_CLASS_MAX` bytes.
+ */
+void*
+size_class_allocate(
+    size_t n
+);
+
+/**
+ *  \brief Return a block to the free list for its size class.
+ */
+void
+size_class_deallocate(
+    void* p,
+    size_t n
+)
+noexcept;
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,36 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Reference counting modes for `shared_ptr`.
+ *
+ *  The `ThreadSafe` parameter of `shared_ptr`, `weak_ptr` and their
+ *  counts selects how references are counted: `false` uses plain
+ *  integers, `true` uses atomic integers, and `SP_BIASED` uses atomic
+ *  counts biased towards the thread creating the object (see
+ *  `biased_count.h`). Each mode has its own control block, so modes
+ *  may be mixed freely within a program.
+ *
+ *  \synopsis
+ *      using sp_mode = int;
+ *      static constexpr sp_mode SP_BIASED = implementation-defined;
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+// Accepts `true` and `false`, for the unbiased modes.
+using sp_mode = int;
+
+// CONSTANTS
+// ---------
+
+static constexpr sp_mode SP_BIASED = 2;
+
+PYCPP_END_NAMESPACE
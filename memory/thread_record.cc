@@ -0,0 +1,151 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/stl/memory/thread_record.h>
+#include <mutex>
+#include <unordered_set>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+struct thread_record_entry
+{
+    std::uint64_t id;
+    thread_record* record;
+    thread_record_entry* next;
+};
+
+// Records claimed by the thread. Trivially destructible, so it remains
+// accessible during thread shutdown, after the flusher has run.
+struct thread_record_cache
+{
+    thread_record_entry* head;
+    bool dead;
+};
+
+static thread_local thread_record_cache cache;
+
+// HELPERS
+// -------
+
+// The registry of live domains is leaked, so it remains valid for
+// threads exiting during static destruction.
+static
+std::mutex&
+registry_mutex()
+{
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+
+static
+std::unordered_set<std::uint64_t>&
+registry()
+{
+    static std::unordered_set<std::uint64_t>* set = new std::unordered_set<std::uint64_t>;
+    return *set;
+}
+
+// OBJECTS
+// -------
+
+// Releases the thread's records on exit, if their domain is still
+// alive. The registry lock excludes a concurrent domain destructor.
+struct thread_record_flusher
+{
+    ~thread_record_flusher()
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        thread_record_entry* entry = cache.head;
+        while (entry) {
+            thread_record_entry* next = entry->next;
+            if (registry().count(entry->id)) {
+                entry->record->claimed.store(false, std::memory_order_release);
+            }
+            delete entry;
+            entry = next;
+        }
+        cache.head = nullptr;
+        cache.dead = true;
+    }
+};
+
+static thread_local thread_record_flusher flusher;
+
+// OBJECTS
+// -------
+
+thread_record_list::thread_record_list()
+noexcept:
+    head_(nullptr)
+{
+    static std::atomic<std::uint64_t> counter(1);
+    id_ = counter.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    registry().insert(id_);
+}
+
+
+thread_record_list::~thread_record_list()
+{
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        registry().erase(id_);
+    }
+
+    thread_record* r = head_.load(std::memory_order_acquire);
+    while (r) {
+        thread_record* next = r->next_record;
+        delete r;
+        r = next;
+    }
+}
+
+
+thread_record&
+thread_record_list::local(
+    factory f
+)
+{
+    for (thread_record_entry* entry = cache.head; entry; entry = entry->next) {
+        if (entry->id == id_) {
+            return *entry->record;
+        }
+    }
+
+    thread_record& r = claim(f);
+    if (!cache.dead) {
+        cache.head = new thread_record_entry {id_, &r, cache.head};
+        static_cast<void>(&flusher);
+    }
+    return r;
+}
+
+
+thread_record&
+thread_record_list::claim(
+    factory f
+)
+{
+    // reuse a record released by an exited thread
+    for (thread_record* r = head(); r; r = r->next_record) {
+        bool expected = false;
+        if (!r->claimed.load(std::memory_order_relaxed) && r->claimed.compare_exchange_strong(expected, true, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return *r;
+        }
+    }
+
+    thread_record* r = f();
+    thread_record* old = head_.load(std::memory_order_relaxed);
+    do {
+        r->next_record = old;
+    } while (!head_.compare_exchange_weak(old, r, std::memory_order_release, std::memory_order_relaxed));
+
+    return *r;
+}
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,108 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Per-thread records owned by a reclamation domain.
+ *
+ *  Each thread claims one record from a domain on first use, and
+ *  releases it when the thread exits, so later threads may reuse it,
+ *  along with any objects left in it. Records are kept in a lock-free,
+ *  append-only list, and are only freed with the domain, so other
+ *  threads may traverse the list at any time.
+ *
+ *  Threads cache their records by a domain ID, which is never reused.
+ *  Using a domain from a thread-local destructor, after the thread's
+ *  records were released, claims a record for the remaining lifetime
+ *  of the domain.
+ *
+ *  \synopsis
+ *      struct thread_record
+ *      {
+ *          thread_record* next_record;
+ *          virtual ~thread_record();
+ *      };
+ *
+ *      class thread_record_list
+ *      {
+ *      public:
+ *          thread_record_list() noexcept;
+ *          thread_record_list(const thread_record_list&) = delete;
+ *          thread_record_list& operator=(const thread_record_list&) = delete;
+ *          ~thread_record_list();
+ *
+ *          template <typename Record> Record& local();
+ *          thread_record* head() const noexcept;
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+#include <atomic>
+#include <cstdint>
+
+PYCPP_BEGIN_NAMESPACE
+
+// OBJECTS
+// -------
+
+// THREAD RECORD
+
+/**
+ *  \brief Base for records claimed by a single thread.
+ */
+struct thread_record
+{
+    thread_record* next_record = nullptr;
+    std::atomic<bool> claimed {true};
+
+    virtual ~thread_record() = default;
+};
+
+// THREAD RECORD LIST
+
+/**
+ *  \brief Append-only list of per-thread records.
+ */
+class thread_record_list
+{
+public:
+    thread_record_list() noexcept;
+    thread_record_list(const thread_record_list&) = delete;
+    thread_record_list& operator=(const thread_record_list&) = delete;
+    ~thread_record_list();
+
+    // Get the calling thread's record, claiming one if needed.
+    template <typename Record>
+    Record&
+    local()
+    {
+        return static_cast<Record&>(local(&create<Record>));
+    }
+
+    thread_record*
+    head()
+    const noexcept
+    {
+        return head_.load(std::memory_order_acquire);
+    }
+
+private:
+    using factory = thread_record* (*)();
+
+    template <typename Record>
+    static
+    thread_record*
+    create()
+    {
+        return new Record;
+    }
+
+    thread_record& local(factory f);
+    thread_record& claim(factory f);
+
+    std::uint64_t id_;
+    std::atomic<thread_record*> head_;
+};
+
+PYCPP_END_NAMESPACE
@@ -28,7 +28,10 @@
 #pragma once
 
 #include <pycpp/stl/memory/destroy.h>
+#include <pycpp/stl/type_traits/is_zero_initializable.h>
+#include <cstring>
 #include <iterator>
+#include <type_traits>
 #include <utility>
 
 PYCPP_BEGIN_NAMESPACE
@@ -42,8 +45,6 @@ using std::uninitialized_move;
 using std::uninitialized_move_n;
 using std::uninitialized_default_construct;
 using std::uninitialized_default_construct_n;
-using std::uninitialized_value_construct;
-using std::uninitialized_value_construct_n;
 
 #else                       // !CPP17
 
@@ -135,13 +136,40 @@ uninitialized_default_construct_n(
     }
 }
 
+#endif                      // CPP17
+
+// HELPERS
+// -------
 
+// Value-initialized objects in a contiguous range of
+// zero-initializable types can be constructed via `memset`.
 template <typename ForwardIter>
+using is_zero_constructible_range = std::integral_constant<
+    bool,
+    std::is_pointer<ForwardIter>::value &&
+    is_zero_initializable<typename std::iterator_traits<ForwardIter>::value_type>::value
+>;
+
+template <typename T>
 inline
 void
-uninitialized_value_construct(
+uninitialized_value_construct_impl(
+    T* first,
+    T* last,
+    std::true_type
+)
+noexcept
+{
+    std::memset(static_cast<void*>(first), 0, static_cast<size_t>(last - first) * sizeof(T));
+}
+
+template <typename ForwardIter>
+inline
+void
+uninitialized_value_construct_impl(
     ForwardIter first,
-    ForwardIter last
+    ForwardIter last,
+    std::false_type
 )
 {
     using value_type = typename std::iterator_traits<ForwardIter>::value_type;
@@ -156,12 +184,30 @@ uninitialized_value_construct(
     }
 }
 
+template <typename T, typename Size>
+inline
+T*
+uninitialized_value_construct_n_impl(
+    T* first,
+    Size n,
+    std::true_type
+)
+noexcept
+{
+    if (n > 0) {
+        std::memset(static_cast<void*>(first), 0, static_cast<size_t>(n) * sizeof(T));
+        return first + n;
+    }
+    return first;
+}
+
 template <typename ForwardIter, typename Size>
 inline
 ForwardIter
-uninitialized_value_construct_n(
+uninitialized_value_construct_n_impl(
     ForwardIter first,
-    Size n
+    Size n,
+    std::false_type
 )
 {
     using value_type = typename std::iterator_traits<ForwardIter>::value_type;
@@ -177,6 +223,29 @@ uninitialized_value_construct_n(
     }
 }
 
-#endif                      // CPP17
+// FUNCTIONS
+// ---------
+
+template <typename ForwardIter>
+inline
+void
+uninitialized_value_construct(
+    ForwardIter first,
+    ForwardIter last
+)
+{
+    uninitialized_value_construct_impl(first, last, is_zero_constructible_range<ForwardIter>());
+}
+
+template <typename ForwardIter, typename Size>
+inline
+ForwardIter
+uninitialized_value_construct_n(
+    ForwardIter first,
+    Size n
+)
+{
+    return uninitialized_value_construct_n_impl(first, n, is_zero_constructible_range<ForwardIter>());
+}
 
 PYCPP_END_NAMESPACE
@@ -6,13 +6,13 @@
  *  \brief `weak_ptr` with single-threaded optimizations.
  *
  *  \synopsis
- *      template <typename T, bool ThreadSafe>
+ *      template <typename T, sp_mode ThreadSafe>
  *      class weak_ptr
  *      {
  *      public:
  *          using element_type = typename std::remove_extent<T>::type;
  *          using count_type = weak_count<ThreadSafe>;
- *          static constexpr bool thread_safe = ThreadSafe;
+ *          static constexpr sp_mode thread_safe = ThreadSafe;
  *
  *          constexpr weak_ptr() noexcept;
  *          weak_ptr(const weak_ptr& r);
@@ -53,7 +53,7 @@
  *          bool owner_before(const shared_ptr<U, thread_safe>& x) const noexcept;
  *      };
  *
- *      template <typename T, bool ThreadSafe>
+ *      template <typename T, sp_mode ThreadSafe>
  *      void swap(weak_ptr<T, ThreadSafe>& x, weak_ptr<T, ThreadSafe>& y);
  */
 
@@ -68,7 +68,7 @@ PYCPP_BEGIN_NAMESPACE
 // OBJECTS
 // -------
 
-template <typename T, bool ThreadSafe>
+template <typename T, sp_mode ThreadSafe>
 class weak_ptr
 {
 public:
@@ -76,7 +76,7 @@ public:
     // ------------
     using element_type = typename std::remove_extent<T>::type;
     using count_type = weak_count<ThreadSafe>;
-    static constexpr bool thread_safe = ThreadSafe;
+    static constexpr sp_mode thread_safe = ThreadSafe;
 
     // Constructors
     constexpr
@@ -103,7 +103,7 @@ public:
         ctrl_(r.ctrl_)
     {
         static_assert(
-            std::is_convertible<U, T>::value,
+            std::is_convertible<U*, T*>::value,
             "U must be convertible to T."
         );
     }
@@ -117,7 +117,7 @@ public:
         ctrl_(r.ctrl_)
     {
         static_assert(
-            std::is_convertible<U, T>::value,
+            std::is_convertible<U*, T*>::value,
             "U must be convertible to T."
         );
     }
@@ -141,7 +141,7 @@ public:
         ctrl_(std::move(r.ctrl_))
     {
         static_assert(
-            std::is_convertible<U, T>::value,
+            std::is_convertible<U*, T*>::value,
             "U must be convertible to T."
         );
 
@@ -167,7 +167,7 @@ public:
     noexcept
     {
         static_assert(
-            std::is_convertible<U, T>::value,
+            std::is_convertible<U*, T*>::value,
             "U must be convertible to T."
         );
 
@@ -184,7 +184,7 @@ public:
     noexcept
     {
         static_assert(
-            std::is_convertible<U, T>::value,
+            std::is_convertible<U*, T*>::value,
             "U must be convertible to T."
         );
 
@@ -273,12 +273,15 @@ private:
     element_type* ptr_;
     count_type ctrl_;
 
-    template <typename, bool> friend class weak_ptr;
-    template <typename, bool> friend class shared_ptr;
+    template <typename, sp_mode> friend class weak_ptr;
+    template <typename, sp_mode> friend class shared_ptr;
+
+    template <typename U, bool Threaded>
+    friend bool sp_equivalent(const weak_ptr<U, Threaded>&, const weak_ptr<U, Threaded>&) noexcept;
 };
 
 
-template <typename T, bool ThreadSafe>
+template <typename T, sp_mode ThreadSafe>
 void swap(
     weak_ptr<T, ThreadSafe>& x,
     weak_ptr<T, ThreadSafe>& y
@@ -291,7 +294,7 @@ noexcept
 // SPECIALIZATION
 // --------------
 
-template <typename T, bool ThreadSafe>
+template <typename T, sp_mode ThreadSafe>
 struct is_relocatable<weak_ptr<T, ThreadSafe>>: is_relocatable<weak_count<ThreadSafe>>
 {};
 
@@ -20,7 +20,11 @@
 #pragma once
 
 #include <pycpp/config.h>
+#include <pycpp/stl/memory_resource/fallback_resource.h>
+#include <pycpp/stl/memory_resource/numa_resource.h>
 #include <pycpp/stl/memory_resource/polymorphic_allocator.h>
+#include <pycpp/stl/memory_resource/static_resource_allocator.h>
+#include <pycpp/stl/memory_resource/stats_resource.h>
 
 // Right now we depend on some non-standard extensions to
 // polymorphic allocator, specifically,
@@ -0,0 +1,253 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/stl/memory_resource/fallback_resource.h>
+#include <algorithm>
+#include <cstring>
+
+PYCPP_BEGIN_NAMESPACE
+
+namespace pmr
+{
+// HELPERS
+// -------
+
+static
+uintptr_t
+address(
+    const void* p
+)
+noexcept
+{
+    return reinterpret_cast<uintptr_t>(p);
+}
+
+// OBJECTS
+// -------
+
+fallback_resource::fallback_resource(
+    memory_resource* primary
+)
+noexcept:
+    fallback_resource(primary, get_default_resource())
+{}
+
+
+fallback_resource::fallback_resource(
+    memory_resource* primary,
+    memory_resource* secondary
+)
+noexcept:
+    primary_(primary),
+    secondary_(secondary),
+    ranges_(range_allocator(primary))
+{}
+
+
+memory_resource*
+fallback_resource::primary_resource()
+const noexcept
+{
+    return primary_;
+}
+
+
+memory_resource*
+fallback_resource::secondary_resource()
+const noexcept
+{
+    return secondary_;
+}
+
+
+void*
+fallback_resource::do_allocate(
+    size_t n,
+    size_t alignment
+)
+{
+    void* p;
+    try {
+        p = primary_->allocate(n, alignment);
+    } catch (std::bad_alloc&) {
+        return secondary_->allocate(n, alignment);
+    }
+
+    if (primary_->owns(p) == resource_ownership::unknown) {
+        try {
+            track(p, n);
+        } catch (std::bad_alloc&) {
+            // no room in the primary to track the block
+            primary_->deallocate(p, n, alignment);
+            return secondary_->allocate(n, alignment);
+        }
+    }
+
+    return p;
+}
+
+
+void*
+fallback_resource::do_reallocate(
+    void* p,
+    size_t old_size,
+    size_t new_size,
+    size_t n,
+    size_t old_offset,
+    size_t new_offset,
+    size_t alignment
+)
+{
+    if (!from_primary(p)) {
+        return secondary_->reallocate(p, old_size, new_size, n, old_offset, new_offset, alignment);
+    }
+
+    void* pout;
+    try {
+        pout = primary_->reallocate(p, old_size, new_size, n, old_offset, new_offset, alignment);
+    } catch (std::bad_alloc&) {
+        // primary is exhausted, move the block to the secondary
+        return move_to_secondary(p, old_size, new_size, n, old_offset, new_offset, alignment);
+    }
+
+    if (primary_->owns(pout) != resource_ownership::unknown) {
+        return pout;
+    } else if (pout == p) {
+        // grown in-place, update the range without allocating
+        ranges_.find(address(p))->second = new_size;
+        return pout;
+    }
+
+    // erasing the old range first releases a node for the new range
+    untrack(p);
+    try {
+        track(pout, new_size);
+    } catch (std::bad_alloc&) {
+        return move_to_secondary(pout, new_size, new_size, n, new_offset, new_offset, alignment);
+    }
+
+    return pout;
+}
+
+
+void
+fallback_resource::do_deallocate(
+    void* p,
+    size_t n,
+    size_t alignment
+)
+{
+    if (from_primary(p)) {
+        untrack(p);
+        primary_->deallocate(p, n, alignment);
+    } else {
+        secondary_->deallocate(p, n, alignment);
+    }
+}
+
+
+bool
+fallback_resource::do_is_equal(
+    const memory_resource& x
+)
+const noexcept
+{
+    return this == &x;
+}
+
+
+resource_ownership
+fallback_resource::do_owns(
+    const void* p
+)
+const noexcept
+{
+    if (from_primary(p)) {
+        return resource_ownership::owned;
+    }
+    return secondary_->owns(p);
+}
+
+
+bool
+fallback_resource::from_primary(
+    const void* p
+)
+const noexcept
+{
+    switch (primary_->owns(p)) {
+        case resource_ownership::owned:
+            return true;
+        case resource_ownership::foreign:
+            return false;
+        default:
+            return find(p) != ranges_.end();
+    }
+}
+
+
+auto
+fallback_resource::find(
+    const void* p
+)
+const noexcept
+-> range_table::const_iterator
+{
+    // find the last range starting at or before `p`
+    uintptr_t x = address(p);
+    auto it = ranges_.upper_bound(x);
+    if (it == ranges_.begin()) {
+        return ranges_.end();
+    }
+
+    --it;
+    size_t size = std::max<size_t>(it->second, 1);
+    return x - it->first < size ? it : ranges_.end();
+}
+
+
+// Throws `std::bad_alloc` if the primary has no room for the node.
+void
+fallback_resource::track(
+    void* p,
+    size_t n
+)
+{
+    ranges_.emplace(address(p), n);
+}
+
+
+void
+fallback_resource::untrack(
+    void* p
+)
+noexcept
+{
+    ranges_.erase(address(p));
+}
+
+
+// Move a block from the primary to the secondary, releasing its range.
+void*
+fallback_resource::move_to_secondary(
+    void* p,
+    size_t old_size,
+    size_t new_size,
+    size_t n,
+    size_t old_offset,
+    size_t new_offset,
+    size_t alignment
+)
+{
+    void* pout = secondary_->allocate(new_size, alignment);
+    byte* psrc = static_cast<byte*>(p);
+    byte* pdest = static_cast<byte*>(pout);
+    std::memcpy(pdest + new_offset, psrc + old_offset, n);
+    untrack(p);
+    primary_->deallocate(p, old_size, alignment);
+    return pout;
+}
+
+}   /* pmr */
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,142 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Memory resource composing a primary and a secondary resource.
+ *
+ *  Requests are served by the primary resource, and fall back to the
+ *  secondary resource when the primary throws `std::bad_alloc`.
+ *  Deallocation and reallocation are routed to the resource that
+ *  allocated the block: primaries that can tell ownership cheaply,
+ *  through `owns()`, are queried directly, otherwise the blocks served
+ *  by the primary are tracked in a balanced tree of ranges, for
+ *  logarithmic lookups and updates. The tree is allocated from the
+ *  primary, so it is bounded by the primary's capacity: a block whose
+ *  range cannot be tracked is served by the secondary instead. Blocks
+ *  that cannot grow in the primary are moved to the secondary.
+ *
+ *  Longer chains are built by nesting resources, and a
+ *  `null_memory_resource` secondary bounds the chain, IE, an arena
+ *  over a pool over the heap, or an arena that never overflows.
+ *  Like the standard unsynchronized resources, the fallback resource
+ *  is not thread-safe.
+ *
+ *  \synopsis
+ *      class fallback_resource final: public memory_resource
+ *      {
+ *      public:
+ *          explicit fallback_resource(memory_resource* primary) noexcept;
+ *          fallback_resource(memory_resource* primary, memory_resource* secondary) noexcept;
+ *          fallback_resource(const fallback_resource&) = delete;
+ *          fallback_resource& operator=(const fallback_resource&) = delete;
+ *          ~fallback_resource() = default;
+ *
+ *          memory_resource* primary_resource() const noexcept;
+ *          memory_resource* secondary_resource() const noexcept;
+ *
+ *      protected:
+ *          virtual void* do_allocate(size_t, size_t) override;
+ *          virtual void* do_reallocate(void*, size_t, size_t, size_t, size_t, size_t, size_t) override;
+ *          virtual void do_deallocate(void*, size_t, size_t) override;
+ *          virtual bool do_is_equal(const memory_resource&) const noexcept override;
+ *          virtual resource_ownership do_owns(const void*) const noexcept override;
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory_resource/polymorphic_allocator.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+
+PYCPP_BEGIN_NAMESPACE
+
+namespace pmr
+{
+// OBJECTS
+// -------
+
+/**
+ *  \brief Resource falling back to a secondary when the primary is exhausted.
+ */
+class fallback_resource final: public memory_resource
+{
+public:
+    explicit fallback_resource(memory_resource* primary) noexcept;
+    fallback_resource(memory_resource* primary, memory_resource* secondary) noexcept;
+    fallback_resource(const fallback_resource&) = delete;
+    fallback_resource& operator=(const fallback_resource&) = delete;
+    ~fallback_resource() = default;
+
+    memory_resource* primary_resource() const noexcept;
+    memory_resource* secondary_resource() const noexcept;
+
+    friend struct static_resource_access;
+
+protected:
+    virtual
+    void*
+    do_allocate(
+        size_t n,
+        size_t alignment
+    )
+    override;
+
+    virtual
+    void*
+    do_reallocate(
+        void* p,
+        size_t old_size,
+        size_t new_size,
+        size_t n,
+        size_t old_offset,
+        size_t new_offset,
+        size_t alignment
+    )
+    override;
+
+    virtual
+    void
+    do_deallocate(
+        void* p,
+        size_t n,
+        size_t alignment
+    )
+    override;
+
+    virtual
+    bool
+    do_is_equal(
+        const memory_resource& x
+    )
+    const noexcept
+    override;
+
+    virtual
+    resource_ownership
+    do_owns(
+        const void* p
+    )
+    const noexcept
+    override;
+
+private:
+    // maps the first address of each range to its size
+    using range_allocator = polymorphic_allocator<std::pair<const uintptr_t, size_t>>;
+    using range_table = std::map<uintptr_t, size_t, std::less<uintptr_t>, range_allocator>;
+
+    bool from_primary(const void* p) const noexcept;
+    range_table::const_iterator find(const void* p) const noexcept;
+    void track(void* p, size_t n);
+    void untrack(void* p) noexcept;
+    void* move_to_secondary(void* p, size_t old_size, size_t new_size, size_t n, size_t old_offset, size_t new_offset, size_t alignment);
+
+    memory_resource* primary_;
+    memory_resource* secondary_;
+    range_table ranges_;
+};
+
+}   /* pmr */
+
+PYCPP_END_NAMESPACE
@@ -6,6 +6,13 @@
  *  \brief Memory resource definition.
  *
  *  \synopsis
+ *      enum class resource_ownership
+ *      {
+ *          unknown,
+ *          owned,
+ *          foreign,
+ *      };
+ *
  *      struct memory_resource
  *      {
  *      public:
@@ -26,6 +33,7 @@
  *
  *          void deallocate(void* p, size_t n, size_t alignment = implementation-defined);
  *          bool is_equal(const memory_resource&) const noexcept;
+ *          resource_ownership owns(const void* p) const noexcept;
  *
  *      protected:
  *          virtual void* do_allocate(size_t n, size_t alignment) = 0;
@@ -44,6 +52,7 @@
  *
  *          virtual void do_deallocate(void* p, size_t n, size_t alignment) = 0;
  *          virtual bool do_is_equal(const memory_resource&) const noexcept;
+ *          virtual resource_ownership do_owns(const void* p) const noexcept;
  *      };
  */
 
@@ -53,6 +62,8 @@
 #include <pycpp/stl/cstddef/byte.h>
 #include <pycpp/stl/memory/allocator_traits.h>
 #include <atomic>
+#include <cassert>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <new>
@@ -64,9 +75,28 @@ PYCPP_BEGIN_NAMESPACE
 
 namespace pmr
 {
+// FORWARD
+// -------
+
+struct static_resource_access;
+
 // OBJECTS
 // -------
 
+// RESOURCE OWNERSHIP
+
+/**
+ *  \brief Whether a resource allocated a given address.
+ *
+ *  Resources that cannot tell cheaply report `unknown`.
+ */
+enum class resource_ownership
+{
+    unknown,
+    owned,
+    foreign,
+};
+
 // MEMORY RESOURCE
 
 /**
@@ -122,6 +152,16 @@ public:
         return do_is_equal(x);
     }
 
+    // Non-standard extension: check if `p` was allocated by the resource.
+    resource_ownership
+    owns(
+        const void* p
+    )
+    const noexcept
+    {
+        return do_owns(p);
+    }
+
 protected:
     virtual
     void*
@@ -174,6 +214,16 @@ protected:
         return this == &x;
     }
 
+    virtual
+    resource_ownership
+    do_owns(
+        const void*
+    )
+    const noexcept
+    {
+        return resource_ownership::unknown;
+    }
+
 private:
     static std::atomic<memory_resource*> default_resource_;
 
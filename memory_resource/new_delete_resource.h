@@ -6,7 +6,7 @@
  *  \brief Memory resource that uses new/delete.
  *
  *  \synopsis
- *      struct new_delete_resource: public memory_resource
+ *      struct new_delete_resource final: public memory_resource
  *      {
  *      public:
  *          ~new_delete_resource() = default;
@@ -30,11 +30,13 @@ namespace pmr
 // OBJECTS
 // -------
 
-struct new_delete_resource: public memory_resource
+struct new_delete_resource final: public memory_resource
 {
 public:
     ~new_delete_resource() = default;
 
+    friend struct static_resource_access;
+
 protected:
     virtual
     void*
@@ -6,7 +6,7 @@
  *  \brief Memory resource that does not allocate memory.
  *
  *  \synopsis
-*       struct null_memory_resource: public memory_resource
+*       struct null_memory_resource final: public memory_resource
 *       {
 *       public:
 *           ~null_memory_resource() = default;
@@ -14,6 +14,7 @@
 *       protected:
 *           virtual void* do_allocate(size_t, size_t) override;
 *           virtual void do_deallocate(void*, size_t, size_t) override;
+*           virtual resource_ownership do_owns(const void*) const noexcept override;
 *       };
  */
 
@@ -30,11 +31,13 @@ namespace pmr
 // OBJECTS
 // -------
 
-struct null_memory_resource: public memory_resource
+struct null_memory_resource final: public memory_resource
 {
 public:
     ~null_memory_resource() = default;
 
+    friend struct static_resource_access;
+
 protected:
     virtual
     void*
@@ -51,6 +54,15 @@ protected:
     {
         assert(p == nullptr || n == 0);
     }
+
+    virtual
+    resource_ownership
+    do_owns(const void*)
+    const noexcept
+    override
+    {
+        return resource_ownership::foreign;
+    }
 };
 
 }   /* pmr */
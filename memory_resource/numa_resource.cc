@@ -0,0 +1,427 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/preprocessor/os.h>
+#include <pycpp/stl/memory_resource/numa_resource.h>
+#include <climits>
+#if defined(PYCPP_WINDOWS)
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+#if defined(__linux__)
+#   include <sys/syscall.h>
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+namespace pmr
+{
+// HELPERS
+// -------
+
+#if defined(__linux__)
+
+// Memory policy modes and flags, from <linux/mempolicy.h>.
+static constexpr int NUMA_MPOL_PREFERRED = 1;
+static constexpr int NUMA_MPOL_BIND = 2;
+static constexpr int NUMA_MPOL_INTERLEAVE = 3;
+static constexpr unsigned long NUMA_MPOL_F_MEMS_ALLOWED = 1 << 2;
+
+// Largest node mask passed to the kernel.
+static constexpr size_t NUMA_MAX_NODES = 1024;
+static constexpr size_t NUMA_MASK_BITS = CHAR_BIT * sizeof(unsigned long);
+
+struct node_mask
+{
+    unsigned long bits[NUMA_MAX_NODES / NUMA_MASK_BITS];
+};
+
+#endif
+
+
+static
+size_t
+page_round(
+    size_t n,
+    size_t page
+)
+noexcept
+{
+    return n == 0 ? page : (n + page - 1) & ~(page - 1);
+}
+
+#if defined(PYCPP_WINDOWS)          // WINDOWS
+
+static
+size_t
+page_size()
+noexcept
+{
+    static size_t size = [] {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+    }();
+    return size;
+}
+
+
+static
+size_t
+allocation_granularity()
+noexcept
+{
+    static size_t size = [] {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwAllocationGranularity);
+    }();
+    return size;
+}
+
+
+static
+void*
+map_pages(
+    size_t n,
+    size_t alignment,
+    numa_policy policy,
+    int node
+)
+{
+    if (alignment > allocation_granularity()) {
+        throw std::bad_alloc();
+    }
+
+    // Windows has no interleave policy, so leave placement to the OS
+    size_t size = page_round(n, page_size());
+    void* p;
+    if (policy == numa_policy::local) {
+        node = numa_resource::current_node();
+    }
+    if (policy != numa_policy::interleave && node >= 0 && numa_resource::node_count() > 1) {
+        p = VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, static_cast<DWORD>(node));
+    } else {
+        p = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    }
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+
+static
+void
+unmap_pages(
+    void* p,
+    size_t
+)
+noexcept
+{
+    VirtualFree(p, 0, MEM_RELEASE);
+}
+
+#else                               // POSIX
+
+static
+size_t
+page_size()
+noexcept
+{
+    static size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+#if defined(__linux__)
+
+static
+bool
+allowed_nodes(
+    node_mask& mask
+)
+noexcept
+{
+    mask = node_mask {};
+    return syscall(SYS_get_mempolicy, nullptr, mask.bits, NUMA_MAX_NODES, nullptr, NUMA_MPOL_F_MEMS_ALLOWED) == 0;
+}
+
+
+static
+void
+set_node(
+    node_mask& mask,
+    int node
+)
+noexcept
+{
+    size_t index = static_cast<size_t>(node);
+    mask.bits[index / NUMA_MASK_BITS] |= 1UL << (index % NUMA_MASK_BITS);
+}
+
+
+// Set the memory policy before the pages are first touched. The
+// policy is only a placement hint, so failures are ignored.
+static
+void
+apply_policy(
+    void* p,
+    size_t n,
+    numa_policy policy,
+    int node
+)
+noexcept
+{
+    if (numa_resource::node_count() <= 1) {
+        return;
+    }
+
+    node_mask mask = {};
+    int mode;
+    switch (policy) {
+        case numa_policy::local:
+            mode = NUMA_MPOL_PREFERRED;
+            set_node(mask, numa_resource::current_node());
+            break;
+        case numa_policy::bind:
+            if (node < 0 || static_cast<size_t>(node) >= NUMA_MAX_NODES) {
+                return;
+            }
+            mode = NUMA_MPOL_BIND;
+            set_node(mask, node);
+            break;
+        default:
+            if (!allowed_nodes(mask)) {
+                return;
+            }
+            mode = NUMA_MPOL_INTERLEAVE;
+            break;
+    }
+
+    // the kernel ignores the last bit of `maxnode`
+    syscall(SYS_mbind, p, n, mode, mask.bits, NUMA_MAX_NODES + 1, 0);
+}
+
+#endif
+
+
+static
+void*
+map_pages(
+    size_t n,
+    size_t alignment,
+    numa_policy policy,
+    int node
+)
+{
+    // over-allocate for alignments stricter than a page, and trim
+    size_t page = page_size();
+    size_t size = page_round(n, page);
+    size_t extra = alignment > page ? alignment - page : 0;
+    void* p = mmap(nullptr, size + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+
+    if (extra) {
+        char* first = static_cast<char*>(p);
+        uintptr_t x = reinterpret_cast<uintptr_t>(p);
+        size_t head = static_cast<size_t>(((x + alignment - 1) & ~(alignment - 1)) - x);
+        if (head) {
+            munmap(first, head);
+        }
+        if (extra - head) {
+            munmap(first + head + size, extra - head);
+        }
+        p = first + head;
+    }
+
+#if defined(__linux__)
+    apply_policy(p, size, policy, node);
+#else
+    static_cast<void>(policy);
+    static_cast<void>(node);
+#endif
+
+    return p;
+}
+
+
+static
+void
+unmap_pages(
+    void* p,
+    size_t n
+)
+noexcept
+{
+    munmap(p, page_round(n, page_size()));
+}
+
+#endif
+
+// OBJECTS
+// -------
+
+numa_resource::numa_resource()
+noexcept:
+    numa_resource(numa_policy::local)
+{}
+
+
+numa_resource::numa_resource(
+    int node
+)
+noexcept:
+    numa_resource(numa_policy::bind, node)
+{}
+
+
+numa_resource::numa_resource(
+    numa_policy policy,
+    int node
+)
+noexcept:
+    policy_(policy),
+    node_(node)
+{}
+
+
+numa_policy
+numa_resource::policy()
+const noexcept
+{
+    return policy_;
+}
+
+
+int
+numa_resource::node()
+const noexcept
+{
+    return node_;
+}
+
+
+int
+numa_resource::node_count()
+noexcept
+{
+#if defined(PYCPP_WINDOWS)
+    static int count = [] {
+        ULONG highest;
+        return GetNumaHighestNodeNumber(&highest) ? static_cast<int>(highest) + 1 : 1;
+    }();
+#elif defined(__linux__)
+    static int count = [] {
+        node_mask mask;
+        if (!allowed_nodes(mask)) {
+            return 1;
+        }
+        int nodes = 0;
+        for (unsigned long bits: mask.bits) {
+            for (; bits; bits &= bits - 1) {
+                ++nodes;
+            }
+        }
+        return nodes ? nodes : 1;
+    }();
+#else
+    static int count = 1;
+#endif
+    return count;
+}
+
+
+int
+numa_resource::current_node()
+noexcept
+{
+#if defined(PYCPP_WINDOWS)
+    PROCESSOR_NUMBER processor;
+    USHORT node;
+    GetCurrentProcessorNumberEx(&processor);
+    return GetNumaProcessorNodeEx(&processor, &node) ? static_cast<int>(node) : 0;
+#elif defined(__linux__)
+    unsigned cpu;
+    unsigned node;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+        return 0;
+    }
+    return static_cast<int>(node);
+#else
+    return 0;
+#endif
+}
+
+
+void*
+numa_resource::do_allocate(
+    size_t n,
+    size_t alignment
+)
+{
+    return map_pages(n, alignment, policy_, node_);
+}
+
+
+void*
+numa_resource::do_reallocate(
+    void* p,
+    size_t old_size,
+    size_t new_size,
+    size_t n,
+    size_t old_offset,
+    size_t new_offset,
+    size_t alignment
+)
+{
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+    // remap the pages, which keeps their policy, unless the data
+    // moves within the buffer or the alignment must be preserved
+    size_t page = page_size();
+    if (old_offset == new_offset && alignment <= page) {
+        size_t old_bytes = page_round(old_size, page);
+        size_t new_bytes = page_round(new_size, page);
+        if (old_bytes == new_bytes) {
+            return p;
+        }
+        void* pout = mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (pout == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return pout;
+    }
+#endif
+
+    return memory_resource::do_reallocate(p, old_size, new_size, n, old_offset, new_offset, alignment);
+}
+
+
+void
+numa_resource::do_deallocate(
+    void* p,
+    size_t n,
+    size_t
+)
+{
+    unmap_pages(p, n);
+}
+
+
+bool
+numa_resource::do_is_equal(
+    const memory_resource& x
+)
+const noexcept
+{
+    // pages from any NUMA resource may be unmapped by another
+    return dynamic_cast<const numa_resource*>(&x) != nullptr;
+}
+
+}   /* pmr */
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,149 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Memory resource placing pages on specific NUMA nodes.
+ *
+ *  Allocations are mapped directly from the OS, rounded to whole pages,
+ *  and assigned a memory policy before they are first touched:
+ *
+ *      - `local` prefers the node of the allocating thread.
+ *      - `bind` restricts pages to a chosen node.
+ *      - `interleave` spreads pages round-robin over all allowed nodes,
+ *          for shared, read-mostly tables.
+ *
+ *  On Linux, the policy is set with the `mbind` system call, without
+ *  requiring libnuma, and reallocation uses `mremap`, preserving the
+ *  policy without copying. On Windows, pages are committed with
+ *  `VirtualAllocExNuma`. Policies are best-effort: on single-node
+ *  machines, or where the system calls are unavailable, the resource
+ *  degrades to a plain page-mapping resource.
+ *
+ *  Since every allocation consumes whole pages, use the resource
+ *  for large buffers, or as the upstream of a pooling resource.
+ *
+ *  \synopsis
+ *      enum class numa_policy
+ *      {
+ *          local,
+ *          bind,
+ *          interleave,
+ *      };
+ *
+ *      class numa_resource final: public memory_resource
+ *      {
+ *      public:
+ *          numa_resource() noexcept;
+ *          explicit numa_resource(int node) noexcept;
+ *          numa_resource(numa_policy policy, int node = -1) noexcept;
+ *          numa_resource(const numa_resource&) = delete;
+ *          numa_resource& operator=(const numa_resource&) = delete;
+ *          ~numa_resource() = default;
+ *
+ *          numa_policy policy() const noexcept;
+ *          int node() const noexcept;
+ *
+ *          static int node_count() noexcept;
+ *          static int current_node() noexcept;
+ *
+ *      protected:
+ *          virtual void* do_allocate(size_t, size_t) override;
+ *          virtual void* do_reallocate(void*, size_t, size_t, size_t, size_t, size_t, size_t) override;
+ *          virtual void do_deallocate(void*, size_t, size_t) override;
+ *          virtual bool do_is_equal(const memory_resource&) const noexcept override;
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory_resource/memory_resource.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+namespace pmr
+{
+// OBJECTS
+// -------
+
+// NUMA POLICY
+
+/**
+ *  \brief Placement of pages allocated by a `numa_resource`.
+ */
+enum class numa_policy
+{
+    local,
+    bind,
+    interleave,
+};
+
+// NUMA RESOURCE
+
+/**
+ *  \brief Page-mapping resource with a NUMA memory policy.
+ */
+class numa_resource final: public memory_resource
+{
+public:
+    numa_resource() noexcept;
+    explicit numa_resource(int node) noexcept;
+    numa_resource(numa_policy policy, int node = -1) noexcept;
+    numa_resource(const numa_resource&) = delete;
+    numa_resource& operator=(const numa_resource&) = delete;
+    ~numa_resource() = default;
+
+    numa_policy policy() const noexcept;
+    int node() const noexcept;
+
+    static int node_count() noexcept;
+    static int current_node() noexcept;
+
+    friend struct static_resource_access;
+
+protected:
+    virtual
+    void*
+    do_allocate(
+        size_t n,
+        size_t alignment
+    )
+    override;
+
+    virtual
+    void*
+    do_reallocate(
+        void* p,
+        size_t old_size,
+        size_t new_size,
+        size_t n,
+        size_t old_offset,
+        size_t new_offset,
+        size_t alignment
+    )
+    override;
+
+    virtual
+    void
+    do_deallocate(
+        void* p,
+        size_t n,
+        size_t alignment
+    )
+    override;
+
+    virtual
+    bool
+    do_is_equal(
+        const memory_resource& x
+    )
+    const noexcept
+    override;
+
+private:
+    numa_policy policy_;
+    int node_;
+};
+
+}   /* pmr */
+
+PYCPP_END_NAMESPACE
@@ -17,6 +17,7 @@
  *          polymorphic_allocator<T>& operator=(const polymorphic_allocator<T>& rhs) = delete;
  *
  *          T* allocate(size_t n);
+ *          T* reallocate(T* p, size_t old_size, size_t new_size, size_t n, size_t old_offset = 0, size_t new_offset = 0);
  *          void deallocate(T* p, size_t n);
  *          polymorphic_allocator select_on_container_copy_construction() const;
  *          memory_resource* resource() const;
@@ -28,6 +29,8 @@
  *      memory_resource* set_default_resource(memory_resource* r) noexcept;
  */
 
+#pragma once
+
 #include <pycpp/stl/memory_resource/memory_resource.h>
 #include <pycpp/stl/memory_resource/new_delete_resource.h>
 #include <pycpp/stl/memory_resource/null_memory_resource.h>
@@ -171,14 +174,16 @@ public:
         return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
     }
 
+    // Forwards to `memory_resource::do_reallocate`, which may
+    // grow the buffer in-place.
     T*
     reallocate(
         T* p,
         size_t old_size,
         size_t new_size,
         size_t n,
-        size_t old_offset,
-        size_t new_offset
+        size_t old_offset = 0,
+        size_t new_offset = 0
     )
     {
         size_t old_bytes = old_size * sizeof(T);
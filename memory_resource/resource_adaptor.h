@@ -55,7 +55,7 @@ max_aligned_allocation_size(
  *  \brief Adapts an STL allocator to a polymorphic resource.
  */
 template <typename Allocator>
-struct resource_adaptor_impl: memory_resource
+struct resource_adaptor_impl final: memory_resource
 {
     using allocator_type = Allocator;
 
@@ -85,6 +85,8 @@ struct resource_adaptor_impl: memory_resource
         return alloc_;
     }
 
+    friend struct static_resource_access;
+
 protected:
     // Memory traits
     virtual
@@ -122,10 +124,19 @@ protected:
             throw std::bad_alloc();
         }
 
+        // The allocator works in storage units, not bytes, so byte
+        // offsets which do not fall on a unit boundary must be copied.
+        if (old_offset % max_align != 0 || new_offset % max_align != 0) {
+            return memory_resource::do_reallocate(p, old_size, new_size, n, old_offset, new_offset, alignment);
+        }
+
         value_type* pv = static_cast<value_type*>(p);
         size_t old_n = aligned_allocation_size(old_size, max_align) / max_align;
         size_t new_n = aligned_allocation_size(new_size, max_align) / max_align;
-        value_type* pout = alloc_traits::reallocate(alloc_, pv, old_n, new_n, n, old_offset, new_offset);
+        size_t count = aligned_allocation_size(n, max_align) / max_align;
+        size_t old_off = old_offset / max_align;
+        size_t new_off = new_offset / max_align;
+        value_type* pout = alloc_traits::reallocate(alloc_, pv, old_n, new_n, count, old_off, new_off);
 
         return static_cast<void*>(pout);
     }
@@ -0,0 +1,454 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Polymorphic allocator with static dispatch to a final resource.
+ *
+ *  `static_resource_allocator<T, Resource>` holds a typed pointer to a
+ *  concrete, `final` memory resource, and calls its overrides directly,
+ *  rather than through the virtual `memory_resource` interface. Calls
+ *  are devirtualized, and inline only for overrides defined in headers,
+ *  such as `new_delete_resource` and `null_memory_resource`; the
+ *  overrides of the stats, fallback and NUMA resources are defined
+ *  out-of-line, and remain direct calls. Resources grant access to their
+ *  protected overrides by befriending `static_resource_access`, as
+ *  the resources provided by PyCPP do, otherwise the public interface
+ *  is used.
+ *
+ *  The allocator converts to and from `polymorphic_allocator`, and
+ *  both use `T*` as their pointer type, so containers share the same
+ *  allocator-erased facets, and hot paths may use static dispatch
+ *  without changing facet types.
+ *
+ *  \synopsis
+ *      struct static_resource_access;
+ *
+ *      template <typename T, typename Resource>
+ *      class static_resource_allocator
+ *      {
+ *      public:
+ *          using value_type = T;
+ *          using resource_type = Resource;
+ *          using propagate_on_container_move_assignment = true_type;
+ *
+ *          template <typename U>
+ *          struct rebind
+ *          {
+ *              using other = static_resource_allocator<U, Resource>;
+ *          };
+ *
+ *          static_resource_allocator(Resource* r) noexcept;
+ *          static_resource_allocator(const static_resource_allocator&) noexcept;
+ *          template <typename U> static_resource_allocator(const static_resource_allocator<U, Resource>&) noexcept;
+ *          template <typename U> explicit static_resource_allocator(const polymorphic_allocator<U>&);
+ *          static_resource_allocator& operator=(const static_resource_allocator&) noexcept;
+ *
+ *          T* allocate(size_t n);
+ *          T* reallocate(T* p, size_t old_size, size_t new_size, size_t n, size_t old_offset = 0, size_t new_offset = 0);
+ *          void deallocate(T* p, size_t n);
+ *          static_resource_allocator select_on_container_copy_construction() const;
+ *          Resource* resource() const noexcept;
+ *
+ *          template <typename U> operator polymorphic_allocator<U>() const noexcept;
+ *      };
+ *
+ *      template <typename T1, typename T2, typename Resource>
+ *      bool operator==(const static_resource_allocator<T1, Resource>&, const static_resource_allocator<T2, Resource>&) noexcept;
+ *
+ *      template <typename T1, typename T2, typename Resource>
+ *      bool operator!=(const static_resource_allocator<T1, Resource>&, const static_resource_allocator<T2, Resource>&) noexcept;
+ *
+ *      template <typename T1, typename T2, typename Resource>
+ *      bool operator==(const static_resource_allocator<T1, Resource>&, const polymorphic_allocator<T2>&);
+ *
+ *      template <typename T1, typename T2, typename Resource>
+ *      bool operator==(const polymorphic_allocator<T1>&, const static_resource_allocator<T2, Resource>&);
+ *
+ *      template <typename T1, typename T2, typename Resource>
+ *      bool operator!=(const static_resource_allocator<T1, Resource>&, const polymorphic_allocator<T2>&);
+ *
+ *      template <typename T1, typename T2, typename Resource>
+ *      bool operator!=(const polymorphic_allocator<T1>&, const static_resource_allocator<T2, Resource>&);
+ */
+
+#pragma once
+
+#include <pycpp/stl/memory_resource/polymorphic_allocator.h>
+#include <pycpp/stl/type_traits/is_final.h>
+#include <typeinfo>
+
+PYCPP_BEGIN_NAMESPACE
+
+namespace pmr
+{
+// OBJECTS
+// -------
+
+// STATIC RESOURCE ACCESS
+
+/**
+ *  \brief Calls the overrides of a final resource without virtual dispatch.
+ *
+ *  Resources befriend this class to allow static dispatch, otherwise,
+ *  calls use the public, virtual interface.
+ */
+struct static_resource_access
+{
+    template <typename Resource>
+    static
+    void*
+    allocate(
+        Resource& r,
+        size_t n,
+        size_t alignment
+    )
+    {
+        return allocate_impl(r, n, alignment, has_access<Resource>());
+    }
+
+    template <typename Resource>
+    static
+    void*
+    reallocate(
+        Resource& r,
+        void* p,
+        size_t old_size,
+        size_t new_size,
+        size_t n,
+        size_t old_offset,
+        size_t new_offset,
+        size_t alignment
+    )
+    {
+        return reallocate_impl(r, p, old_size, new_size, n, old_offset, new_offset, alignment, has_access<Resource>());
+    }
+
+    template <typename Resource>
+    static
+    void
+    deallocate(
+        Resource& r,
+        void* p,
+        size_t n,
+        size_t alignment
+    )
+    {
+        deallocate_impl(r, p, n, alignment, has_access<Resource>());
+    }
+
+private:
+    // Access checks are part of substitution, so this only
+    // detects overrides accessible to `static_resource_access`.
+    template <typename Resource>
+    struct has_access_impl
+    {
+        template <typename R>
+        static char test(decltype(void(std::declval<R&>().R::do_allocate(0, 0)))*);
+
+        template <typename R>
+        static long test(...);
+
+        enum {
+            value = sizeof(test<Resource>(0)) == sizeof(char)
+        };
+    };
+
+    template <typename Resource>
+    using has_access = std::integral_constant<bool, has_access_impl<Resource>::value>;
+
+    template <typename Resource>
+    static
+    void*
+    allocate_impl(
+        Resource& r,
+        size_t n,
+        size_t alignment,
+        std::true_type
+    )
+    {
+        return r.Resource::do_allocate(n, alignment);
+    }
+
+    template <typename Resource>
+    static
+    void*
+    allocate_impl(
+        Resource& r,
+        size_t n,
+        size_t alignment,
+        std::false_type
+    )
+    {
+        return r.allocate(n, alignment);
+    }
+
+    template <typename Resource>
+    static
+    void*
+    reallocate_impl(
+        Resource& r,
+        void* p,
+        size_t old_size,
+        size_t new_size,
+        size_t n,
+        size_t old_offset,
+        size_t new_offset,
+        size_t alignment,
+        std::true_type
+    )
+    {
+        return r.Resource::do_reallocate(p, old_size, new_size, n, old_offset, new_offset, alignment);
+    }
+
+    template <typename Resource>
+    static
+    void*
+    reallocate_impl(
+        Resource& r,
+        void* p,
+        size_t old_size,
+        size_t new_size,
+        size_t n,
+        size_t old_offset,
+        size_t new_offset,
+        size_t alignment,
+        std::false_type
+    )
+    {
+        return r.reallocate(p, old_size, new_size, n, old_offset, new_offset, alignment);
+    }
+
+    template <typename Resource>
+    static
+    void
+    deallocate_impl(
+        Resource& r,
+        void* p,
+        size_t n,
+        size_t alignment,
+        std::true_type
+    )
+    {
+        r.Resource::do_deallocate(p, n, alignment);
+    }
+
+    template <typename Resource>
+    static
+    void
+    deallocate_impl(
+        Resource& r,
+        void* p,
+        size_t n,
+        size_t alignment,
+        std::false_type
+    )
+    {
+        r.deallocate(p, n, alignment);
+    }
+};
+
+// STATIC RESOURCE ALLOCATOR
+
+/**
+ *  \brief STL allocator statically dispatching to a final resource.
+ */
+template <typename T, typename Resource>
+class static_resource_allocator
+{
+public:
+    static_assert(std::is_base_of<memory_resource, Resource>::value, "Resource must derive from memory_resource.");
+#if defined(PYCPP_CPP14) || defined(PYCPP_IS_FINAL)
+    static_assert(is_final<Resource>::value, "Resource must be final.");
+#endif
+
+    using value_type = T;
+    using resource_type = Resource;
+    using propagate_on_container_move_assignment = std::true_type;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = static_resource_allocator<U, Resource>;
+    };
+
+    // Constructors
+    static_resource_allocator(const static_resource_allocator&) noexcept = default;
+    static_resource_allocator& operator=(const static_resource_allocator&) noexcept = default;
+
+    static_resource_allocator(
+        Resource* r
+    )
+    noexcept:
+        resource_(r)
+    {}
+
+    template <typename U>
+    static_resource_allocator(
+        const static_resource_allocator<U, Resource>& rhs
+    )
+    noexcept:
+        resource_(rhs.resource())
+    {}
+
+    // Throws `std::bad_cast` if the resource is not a `Resource`.
+    template <typename U>
+    explicit
+    static_resource_allocator(
+        const polymorphic_allocator<U>& rhs
+    ):
+        resource_(dynamic_cast<Resource*>(rhs.resource()))
+    {
+        if (resource_ == nullptr) {
+            throw std::bad_cast();
+        }
+    }
+
+    // Allocator traits
+    T*
+    allocate(
+        size_t n
+    )
+    {
+        return static_cast<T*>(static_resource_access::allocate(*resource_, n * sizeof(T), alignof(T)));
+    }
+
+    T*
+    reallocate(
+        T* p,
+        size_t old_size,
+        size_t new_size,
+        size_t n,
+        size_t old_offset = 0,
+        size_t new_offset = 0
+    )
+    {
+        size_t old_bytes = old_size * sizeof(T);
+        size_t new_bytes = new_size * sizeof(T);
+        size_t count = n * sizeof(T);
+        size_t old_off = old_offset * sizeof(T);
+        size_t new_off = new_offset * sizeof(T);
+        return static_cast<T*>(static_resource_access::reallocate(*resource_, p, old_bytes, new_bytes, count, old_off, new_off, alignof(T)));
+    }
+
+    void
+    deallocate(
+        T* p,
+        size_t n
+    )
+    {
+        static_resource_access::deallocate(*resource_, p, n * sizeof(T), alignof(T));
+    }
+
+    // Properties
+    static_resource_allocator
+    select_on_container_copy_construction()
+    const
+    {
+        return *this;
+    }
+
+    Resource*
+    resource()
+    const noexcept
+    {
+        return resource_;
+    }
+
+    // Conversions
+    template <typename U>
+    operator polymorphic_allocator<U>()
+    const noexcept
+    {
+        return polymorphic_allocator<U>(resource_);
+    }
+
+private:
+    Resource* resource_;
+};
+
+template <typename T1, typename T2, typename Resource>
+inline
+bool
+operator==(
+    const static_resource_allocator<T1, Resource>& x,
+    const static_resource_allocator<T2, Resource>& y
+)
+noexcept
+{
+    return x.resource() == y.resource() || x.resource()->is_equal(*y.resource());
+}
+
+
+template <typename T1, typename T2, typename Resource>
+inline
+bool
+operator!=(
+    const static_resource_allocator<T1, Resource>& x,
+    const static_resource_allocator<T2, Resource>& y
+)
+noexcept
+{
+    return !(x == y);
+}
+
+
+template <typename T1, typename T2, typename Resource>
+inline
+bool
+operator==(
+    const static_resource_allocator<T1, Resource>& x,
+    const polymorphic_allocator<T2>& y
+)
+{
+    return *x.resource() == *y.resource();
+}
+
+
+template <typename T1, typename T2, typename Resource>
+inline
+bool
+operator==(
+    const polymorphic_allocator<T1>& x,
+    const static_resource_allocator<T2, Resource>& y
+)
+{
+    return *x.resource() == *y.resource();
+}
+
+
+template <typename T1, typename T2, typename Resource>
+inline
+bool
+operator!=(
+    const static_resource_allocator<T1, Resource>& x,
+    const polymorphic_allocator<T2>& y
+)
+{
+    return !(x == y);
+}
+
+
+template <typename T1, typename T2, typename Resource>
+inline
+bool
+operator!=(
+    const polymorphic_allocator<T1>& x,
+    const static_resource_allocator<T2, Resource>& y
+)
+{
+    return !(x == y);
+}
+
+}   /* pmr */
+
+// SPECIALIZATION
+// --------------
+
+template <typename T>
+struct is_relocatable;
+
+template <typename T, typename Resource>
+struct is_relocatable<pmr::static_resource_allocator<T, Resource>>: std::true_type
+{};
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,301 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+
+#include <pycpp/preprocessor/compiler.h>
+#include <pycpp/stl/memory_resource/stats_resource.h>
+#include <ostream>
+#if defined(PYCPP_MSVC)
+#   include <intrin.h>
+#endif
+
+PYCPP_BEGIN_NAMESPACE
+
+namespace pmr
+{
+// HELPERS
+// -------
+
+// Number of significant bits in `n`, IE, the histogram bucket.
+static
+size_t
+bit_width(
+    size_t n
+)
+noexcept
+{
+    if (n == 0) {
+        return 0;
+    }
+#if defined(PYCPP_GNUC) || defined(PYCPP_CLANG)
+    return static_cast<size_t>(numeric_limits<unsigned long long>::digits - __builtin_clzll(n));
+#elif defined(PYCPP_MSVC) && PYCPP_SYSTEM_ARCHITECTURE == 64
+    unsigned long index;
+    _BitScanReverse64(&index, n);
+    return static_cast<size_t>(index) + 1;
+#else
+    size_t width = 0;
+    for (; n; n >>= 1) {
+        ++width;
+    }
+    return width;
+#endif
+}
+
+
+// Only the owning thread writes its counters, so avoid a read-modify-write.
+static
+void
+increment(
+    atomic<size_t>& counter
+)
+noexcept
+{
+    counter.store(counter.load(memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+// FUNCTIONS
+// ---------
+
+std::ostream&
+operator<<(
+    std::ostream& os,
+    const memory_stats& stats
+)
+{
+    os << "allocations: " << stats.allocations << '\n'
+       << "deallocations: " << stats.deallocations << '\n'
+       << "reallocations: " << stats.reallocations
+       << " (in-place: " << stats.inplace_reallocations
+       << ", copied: " << stats.copy_reallocations << ")\n"
+       << "live bytes: " << stats.live_bytes << '\n'
+       << "peak bytes: " << stats.peak_bytes << '\n'
+       << "size histogram:\n";
+
+    for (size_t i = 0; i < STATS_HISTOGRAM_SIZE; ++i) {
+        if (stats.histogram[i] == 0) {
+            continue;
+        } else if (i == 0) {
+            os << "    0: ";
+        } else {
+            os << "    [2^" << (i - 1) << ", 2^" << i << "): ";
+        }
+        os << stats.histogram[i] << '\n';
+    }
+
+    return os;
+}
+
+// OBJECTS
+// -------
+
+// Counters written by a single thread. `reset()` records a baseline
+// rather than clearing the counters, so it never races the owner.
+enum
+{
+    STATS_ALLOCATIONS,
+    STATS_DEALLOCATIONS,
+    STATS_REALLOCATIONS,
+    STATS_INPLACE_REALLOCATIONS,
+    STATS_HISTOGRAM,
+    STATS_COUNTERS = STATS_HISTOGRAM + STATS_HISTOGRAM_SIZE
+};
+
+// Records are allocated separately, and padded so the counters do not
+// share a cache line with the next allocation.
+struct stats_resource::record: thread_record
+{
+    atomic<size_t> counters[STATS_COUNTERS] = {};
+    atomic<size_t> baseline[STATS_COUNTERS] = {};
+    char padding[PYCPP_CACHELINE_SIZE];
+};
+
+
+stats_resource::stats_resource()
+noexcept:
+    stats_resource(get_default_resource())
+{}
+
+
+stats_resource::stats_resource(
+    memory_resource* upstream
+)
+noexcept:
+    upstream_(upstream),
+    live_bytes_(0),
+    peak_bytes_(0)
+{}
+
+
+memory_resource*
+stats_resource::upstream_resource()
+const noexcept
+{
+    return upstream_;
+}
+
+
+memory_stats
+stats_resource::snapshot()
+const noexcept
+{
+    size_t counters[STATS_COUNTERS] = {};
+    for (thread_record* r = records_.head(); r; r = r->next_record) {
+        record& x = static_cast<record&>(*r);
+        for (size_t i = 0; i < STATS_COUNTERS; ++i) {
+            counters[i] += x.counters[i].load(memory_order_relaxed) - x.baseline[i].load(memory_order_relaxed);
+        }
+    }
+
+    memory_stats stats = {};
+    stats.allocations = counters[STATS_ALLOCATIONS];
+    stats.deallocations = counters[STATS_DEALLOCATIONS];
+    stats.reallocations = counters[STATS_REALLOCATIONS];
+    stats.inplace_reallocations = counters[STATS_INPLACE_REALLOCATIONS];
+    stats.copy_reallocations = stats.reallocations - stats.inplace_reallocations;
+    for (size_t i = 0; i < STATS_HISTOGRAM_SIZE; ++i) {
+        stats.histogram[i] = counters[STATS_HISTOGRAM + i];
+    }
+    stats.live_bytes = live_bytes_.load(memory_order_relaxed);
+    stats.peak_bytes = peak_bytes_.load(memory_order_relaxed);
+
+    return stats;
+}
+
+
+void
+stats_resource::reset()
+noexcept
+{
+    // live bytes still reflect outstanding allocations,
+    // so only restart the peak from the current value.
+    for (thread_record* r = records_.head(); r; r = r->next_record) {
+        record& x = static_cast<record&>(*r);
+        for (size_t i = 0; i < STATS_COUNTERS; ++i) {
+            x.baseline[i].store(x.counters[i].load(memory_order_relaxed), memory_order_relaxed);
+        }
+    }
+    peak_bytes_.store(live_bytes_.load(memory_order_relaxed), memory_order_relaxed);
+}
+
+
+void
+stats_resource::dump(
+    std::ostream& os
+)
+const
+{
+    os << snapshot();
+}
+
+
+void*
+stats_resource::do_allocate(
+    size_t n,
+    size_t alignment
+)
+{
+    void* p = upstream_->allocate(n, alignment);
+    atomic<size_t>* counters = local_record().counters;
+    increment(counters[STATS_ALLOCATIONS]);
+    increment(counters[STATS_HISTOGRAM + bit_width(n)]);
+    add_bytes(n);
+
+    return p;
+}
+
+
+void*
+stats_resource::do_reallocate(
+    void* p,
+    size_t old_size,
+    size_t new_size,
+    size_t n,
+    size_t old_offset,
+    size_t new_offset,
+    size_t alignment
+)
+{
+    void* pout = upstream_->reallocate(p, old_size, new_size, n, old_offset, new_offset, alignment);
+    atomic<size_t>* counters = local_record().counters;
+    increment(counters[STATS_REALLOCATIONS]);
+    increment(counters[STATS_HISTOGRAM + bit_width(new_size)]);
+    if (pout == p) {
+        increment(counters[STATS_INPLACE_REALLOCATIONS]);
+    }
+    if (new_size >= old_size) {
+        add_bytes(new_size - old_size);
+    } else {
+        remove_bytes(old_size - new_size);
+    }
+
+    return pout;
+}
+
+
+void
+stats_resource::do_deallocate(
+    void* p,
+    size_t n,
+    size_t alignment
+)
+{
+    upstream_->deallocate(p, n, alignment);
+    increment(local_record().counters[STATS_DEALLOCATIONS]);
+    remove_bytes(n);
+}
+
+
+bool
+stats_resource::do_is_equal(
+    const memory_resource& x
+)
+const noexcept
+{
+    return this == &x;
+}
+
+
+resource_ownership
+stats_resource::do_owns(
+    const void* p
+)
+const noexcept
+{
+    return upstream_->owns(p);
+}
+
+
+auto
+stats_resource::local_record()
+-> record&
+{
+    return records_.local<record>();
+}
+
+
+void
+stats_resource::add_bytes(
+    size_t n
+)
+noexcept
+{
+    // the peak only needs a CAS while it grows
+    size_t live = live_bytes_.fetch_add(n, memory_order_relaxed) + n;
+    size_t peak = peak_bytes_.load(memory_order_relaxed);
+    while (live > peak && !peak_bytes_.compare_exchange_weak(peak, live, memory_order_relaxed)) {
+    }
+}
+
+
+void
+stats_resource::remove_bytes(
+    size_t n
+)
+noexcept
+{
+    live_bytes_.fetch_sub(n, memory_order_relaxed);
+}
+
+}   /* pmr */
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,184 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Memory resource adaptor that records allocation statistics.
+ *
+ *  Counts allocation, deallocation and reallocation calls, whether
+ *  reallocations grew in place or required a copy, and a log2
+ *  histogram of requested sizes, before forwarding the request to an
+ *  upstream resource.
+ *
+ *  The call counters and histogram are kept in records owned by each
+ *  thread, which only that thread writes, so they are updated with a
+ *  relaxed load and store rather than an atomic read-modify-write, and
+ *  never share a cache line with another thread. `snapshot()` merges
+ *  the records. Live and peak bytes are exact, and use a single global
+ *  atomic addition per call, since an exact peak requires a global
+ *  ordering of allocations.
+ *
+ *  \synopsis
+ *      struct memory_stats
+ *      {
+ *          size_t allocations;
+ *          size_t deallocations;
+ *          size_t reallocations;
+ *          size_t inplace_reallocations;
+ *          size_t copy_reallocations;
+ *          size_t live_bytes;
+ *          size_t peak_bytes;
+ *          size_t histogram[implementation-defined];
+ *      };
+ *
+ *      std::ostream& operator<<(std::ostream& os, const memory_stats& stats);
+ *
+ *      class stats_resource final: public memory_resource
+ *      {
+ *      public:
+ *          stats_resource() noexcept;
+ *          explicit stats_resource(memory_resource* upstream) noexcept;
+ *          stats_resource(const stats_resource&) = delete;
+ *          stats_resource& operator=(const stats_resource&) = delete;
+ *          ~stats_resource() = default;
+ *
+ *          memory_resource* upstream_resource() const noexcept;
+ *          memory_stats snapshot() const noexcept;
+ *          void reset() noexcept;
+ *          void dump(std::ostream& os) const;
+ *
+ *      protected:
+ *          virtual void* do_allocate(size_t, size_t) override;
+ *          virtual void* do_reallocate(void*, size_t, size_t, size_t, size_t, size_t, size_t) override;
+ *          virtual void do_deallocate(void*, size_t, size_t) override;
+ *          virtual bool do_is_equal(const memory_resource&) const noexcept override;
+ *          virtual resource_ownership do_owns(const void*) const noexcept override;
+ *      };
+ */
+
+#pragma once
+
+#include <pycpp/preprocessor/cache.h>
+#include <pycpp/stl/atomic.h>
+#include <pycpp/stl/limits.h>
+#include <pycpp/stl/memory/thread_record.h>
+#include <pycpp/stl/memory_resource/polymorphic_allocator.h>
+#include <iosfwd>
+
+PYCPP_BEGIN_NAMESPACE
+
+namespace pmr
+{
+// OBJECTS
+// -------
+
+// Bucket `i` counts requests with a bit width of `i`, IE,
+// bucket 0 is `0`, bucket 1 is `1`, bucket 2 is `[2, 4)`, etc.
+static constexpr size_t STATS_HISTOGRAM_SIZE = numeric_limits<size_t>::digits + 1;
+
+// MEMORY STATS
+
+/**
+ *  \brief Merged statistics from a `stats_resource`.
+ */
+struct memory_stats
+{
+    size_t allocations;
+    size_t deallocations;
+    size_t reallocations;
+    size_t inplace_reallocations;
+    size_t copy_reallocations;
+    size_t live_bytes;
+    size_t peak_bytes;
+    size_t histogram[STATS_HISTOGRAM_SIZE];
+};
+
+std::ostream&
+operator<<(
+    std::ostream& os,
+    const memory_stats& stats
+);
+
+// STATS RESOURCE
+
+/**
+ *  \brief Adaptor recording allocation statistics for an upstream resource.
+ */
+class stats_resource final: public memory_resource
+{
+public:
+    stats_resource() noexcept;
+    explicit stats_resource(memory_resource* upstream) noexcept;
+    stats_resource(const stats_resource&) = delete;
+    stats_resource& operator=(const stats_resource&) = delete;
+    ~stats_resource() = default;
+
+    memory_resource* upstream_resource() const noexcept;
+    memory_stats snapshot() const noexcept;
+    void reset() noexcept;
+    void dump(std::ostream& os) const;
+
+    friend struct static_resource_access;
+
+protected:
+    virtual
+    void*
+    do_allocate(
+        size_t n,
+        size_t alignment
+    )
+    override;
+
+    virtual
+    void*
+    do_reallocate(
+        void* p,
+        size_t old_size,
+        size_t new_size,
+        size_t n,
+        size_t old_offset,
+        size_t new_offset,
+        size_t alignment
+    )
+    override;
+
+    virtual
+    void
+    do_deallocate(
+        void* p,
+        size_t n,
+        size_t alignment
+    )
+    override;
+
+    virtual
+    bool
+    do_is_equal(
+        const memory_resource& x
+    )
+    const noexcept
+    override;
+
+    virtual
+    resource_ownership
+    do_owns(
+        const void* p
+    )
+    const noexcept
+    override;
+
+private:
+    struct record;
+
+    record& local_record();
+    void add_bytes(size_t n) noexcept;
+    void remove_bytes(size_t n) noexcept;
+
+    memory_resource* upstream_;
+    thread_record_list records_;
+    alignas(PYCPP_CACHELINE_SIZE) atomic<size_t> live_bytes_;
+    atomic<size_t> peak_bytes_;
+};
+
+}   /* pmr */
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,50 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Minimal checks for the standalone tests.
+ *
+ *  Each test is a program returning a non-zero status on failure.
+ *  `PYCPP_CHECK` reports failures without aborting, and is evaluated
+ *  regardless of `NDEBUG`.
+ *
+ *  \synopsis
+ *      #define PYCPP_CHECK(condition)      implementation-defined
+ *      int check_status() noexcept;
+ */
+
+#pragma once
+
+#include <cstdio>
+
+// MACROS
+// ------
+
+#define PYCPP_CHECK(condition)                                                  \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            check_failures()++;                                                 \
+        }                                                                       \
+    } while (0)
+
+// FUNCTIONS
+// ---------
+
+inline
+int&
+check_failures()
+noexcept
+{
+    static int failures = 0;
+    return failures;
+}
+
+
+inline
+int
+check_status()
+noexcept
+{
+    return check_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Move assignment of vectors, with and without propagation.
+ */
+
+#include <pycpp/stl/vector.h>
+#include <memory>
+#include <type_traits>
+#include "../check.h"
+
+PYCPP_USING_NAMESPACE
+
+// OBJECTS
+// -------
+
+// Allocator tagged with an identifier, which compares equal only to
+// allocators with the same tag, and counts live allocations per tag.
+template <typename T, bool Propagate>
+struct tagged_allocator
+{
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::integral_constant<bool, Propagate>;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = tagged_allocator<U, Propagate>;
+    };
+
+    int tag;
+    size_t* live;
+
+    tagged_allocator(
+        int t,
+        size_t* l
+    )
+    noexcept:
+        tag(t),
+        live(l)
+    {}
+
+    template <typename U>
+    tagged_allocator(
+        const tagged_allocator<U, Propagate>& x
+    )
+    noexcept:
+        tag(x.tag),
+        live(x.live)
+    {}
+
+    T*
+    allocate(
+        size_t n
+    )
+    {
+        ++live[tag];
+        return std::allocator<T>().allocate(n);
+    }
+
+    void
+    deallocate(
+        T* p,
+        size_t n
+    )
+    {
+        --live[tag];
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    friend
+    bool
+    operator==(
+        const tagged_allocator& x,
+        const tagged_allocator& y
+    )
+    noexcept
+    {
+        return x.tag == y.tag;
+    }
+
+    friend
+    bool
+    operator!=(
+        const tagged_allocator& x,
+        const tagged_allocator& y
+    )
+    noexcept
+    {
+        return !(x == y);
+    }
+};
+
+// Owns a heap value, so leaks and double frees are caught by sanitizers.
+struct boxed
+{
+    std::unique_ptr<int> value;
+
+    boxed(
+        int v
+    ):
+        value(new int(v))
+    {}
+};
+
+PYCPP_BEGIN_NAMESPACE
+
+template <>
+struct is_relocatable<boxed>: std::true_type
+{};
+
+PYCPP_END_NAMESPACE
+
+// TESTS
+// -----
+
+template <bool Propagate>
+static
+void
+test_move_assign(
+    int rhs_tag
+)
+{
+    using allocator_type = tagged_allocator<boxed, Propagate>;
+    size_t live[3] = {};
+    {
+        vector<boxed, allocator_type> x{allocator_type(1, live)};
+        vector<boxed, allocator_type> y{allocator_type(rhs_tag, live)};
+        x.emplace_back(-1);
+        for (int i = 0; i < 100; ++i) {
+            y.emplace_back(i);
+        }
+        const boxed* data = y.data();
+
+        x = move(y);
+        bool stolen = Propagate || rhs_tag == 1;
+        PYCPP_CHECK(x.size() == 100);
+        PYCPP_CHECK((x.data() == data) == stolen);
+        PYCPP_CHECK(*x.front().value == 0 && *x.back().value == 99);
+        if (stolen) {
+            PYCPP_CHECK(y.empty() && y.capacity() == 0);
+        }
+
+        // the old buffer is released, unless it is reused for the
+        // elements moved out of storage from an unequal allocator
+        PYCPP_CHECK(live[1] + live[2] == (stolen ? 1 : 2));
+        PYCPP_CHECK(live[rhs_tag] >= 1);
+
+        // self-contained afterwards
+        y.emplace_back(100);
+        x.emplace_back(100);
+        PYCPP_CHECK(x.size() == 101 && *y.back().value == 100);
+    }
+    PYCPP_CHECK(live[1] == 0 && live[2] == 0);
+}
+
+int
+main()
+{
+    test_move_assign<true>(1);
+    test_move_assign<true>(2);
+    test_move_assign<false>(1);
+    test_move_assign<false>(2);
+    return check_status();
+}
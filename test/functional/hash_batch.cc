@@ -0,0 +1,136 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Results and throughput of `hash_batch`.
+ *
+ *  The batched hashes must match `hash<T>` for every key, including
+ *  the keys left over after the unrolled loop. The throughput of the
+ *  batched and scalar loops is printed for 8- and 16-byte keys, and
+ *  for `uint64_t`, which is hashed by the scalar loop.
+ */
+
+#include <pycpp/stl/functional/hash_batch.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "../check.h"
+
+PYCPP_USING_NAMESPACE
+
+// OBJECTS
+// -------
+
+struct key8
+{
+    uint32_t a;
+    uint32_t b;
+};
+
+struct key16
+{
+    uint64_t a;
+    uint64_t b;
+};
+
+// HELPERS
+// -------
+
+static constexpr size_t KEYS = 1 << 20;
+static constexpr size_t ROUNDS = 16;
+
+template <typename T>
+static
+std::vector<T>
+make_keys(
+    size_t n
+)
+{
+    // distinct bytes in every word, so each key hashes differently
+    std::vector<T> keys(n);
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(keys.data());
+    for (size_t i = 0; i < n * sizeof(T); ++i) {
+        bytes[i] = static_cast<unsigned char>(i * 131 + (i >> 8));
+    }
+    return keys;
+}
+
+
+// Return the millions of keys hashed per second.
+template <typename F>
+static
+double
+throughput(
+    F f
+)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ROUNDS; ++i) {
+        f();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+    return static_cast<double>(KEYS * ROUNDS) * 1e3 / static_cast<double>(ns);
+}
+
+// TESTS
+// -----
+
+template <typename T>
+static
+void
+test_matches_scalar()
+{
+    hash<T> hasher;
+    std::vector<T> keys = make_keys<T>(64);
+    for (size_t n = 0; n <= keys.size(); ++n) {
+        std::vector<hash_result_t> out(n + 1, 0);
+        hash_batch(keys.data(), n, out.data());
+        bool equal = true;
+        for (size_t i = 0; i < n; ++i) {
+            equal = equal && out[i] == static_cast<hash_result_t>(hasher(keys[i]));
+        }
+        PYCPP_CHECK(equal);
+        PYCPP_CHECK(out[n] == 0);
+    }
+}
+
+
+template <typename T>
+static
+void
+bench_throughput(
+    const char* name
+)
+{
+    hash<T> hasher;
+    std::vector<T> keys = make_keys<T>(KEYS);
+    std::vector<hash_result_t> out(KEYS);
+
+    double scalar = throughput([&] {
+        for (size_t i = 0; i < KEYS; ++i) {
+            out[i] = static_cast<hash_result_t>(hasher(keys[i]));
+        }
+    });
+    hash_result_t expected = out[KEYS - 1];
+    double batch = throughput([&] {
+        hash_batch(keys.data(), KEYS, out.data());
+    });
+    PYCPP_CHECK(out[KEYS - 1] == expected);
+
+    std::printf("%-8s scalar %8.1f Mkeys/s, batch %8.1f Mkeys/s\n", name, scalar, batch);
+}
+
+int
+main()
+{
+    test_matches_scalar<key8>();
+    test_matches_scalar<key16>();
+    test_matches_scalar<uint64_t>();
+    bench_throughput<key8>("key8");
+    bench_throughput<key16>("key16");
+    bench_throughput<uint64_t>("uint64_t");
+    return check_status();
+}
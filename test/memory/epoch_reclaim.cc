@@ -0,0 +1,97 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Concurrent readers and writers of an epoch-protected object.
+ */
+
+#include <pycpp/stl/memory/epoch_reclaim.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../check.h"
+
+PYCPP_USING_NAMESPACE
+
+// OBJECTS
+// -------
+
+// Cleared before deletion, so readers notice reclaimed objects.
+struct versioned
+{
+    static constexpr unsigned LIVE = 0x5AFE;
+
+    unsigned magic = LIVE;
+    size_t version;
+
+    explicit
+    versioned(
+        size_t v
+    ):
+        version(v)
+    {}
+};
+
+// TESTS
+// -----
+
+static
+void
+test_concurrent_retire()
+{
+    constexpr size_t readers = 4;
+    constexpr size_t writers = 2;
+    constexpr size_t updates = 20000;
+
+    std::atomic<size_t> deleted(0);
+    std::atomic<size_t> invalid(0);
+    std::atomic<size_t> done(0);
+    {
+        epoch_domain domain;
+        std::atomic<versioned*> current(new versioned(0));
+
+        // the deleter is a lambda, which is neither default-constructible nor assignable
+        auto deleter = [&deleted](versioned* p) {
+            p->magic = 0;
+            delete p;
+            deleted.fetch_add(1, std::memory_order_relaxed);
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < readers; ++i) {
+            threads.emplace_back([&] {
+                while (done.load(std::memory_order_acquire) != writers) {
+                    epoch_guard guard(domain);
+                    versioned* p = current.load(std::memory_order_acquire);
+                    if (p->magic != versioned::LIVE) {
+                        invalid.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+        for (size_t i = 0; i < writers; ++i) {
+            threads.emplace_back([&] {
+                for (size_t j = 1; j <= updates; ++j) {
+                    versioned* old = current.exchange(new versioned(j), std::memory_order_acq_rel);
+                    domain.retire(old, deleter);
+                }
+                done.fetch_add(1, std::memory_order_release);
+            });
+        }
+        for (auto& thread: threads) {
+            thread.join();
+        }
+
+        domain.retire(current.load(), deleter);
+    }
+
+    PYCPP_CHECK(invalid == 0);
+    PYCPP_CHECK(deleted == writers * updates + 1);
+}
+
+int
+main()
+{
+    test_concurrent_retire();
+    return check_status();
+}
@@ -0,0 +1,150 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Contention of 64 threads referencing a single object.
+ *
+ *  Each thread copies and drops references to one shared object, first
+ *  through `shared_ptr`, then through a thread's own `local_ref`, and
+ *  the time per copy is printed for both. The use count must be exact
+ *  after either run.
+ */
+
+#include <pycpp/stl/memory/local_ref.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "../check.h"
+
+PYCPP_USING_NAMESPACE
+
+// OBJECTS
+// -------
+
+struct counted
+{
+    static std::atomic<int> alive;
+
+    counted()
+    {
+        ++alive;
+    }
+
+    ~counted()
+    {
+        --alive;
+    }
+};
+
+std::atomic<int> counted::alive(0);
+
+// HELPERS
+// -------
+
+static constexpr size_t THREADS = 64;
+static constexpr size_t COPIES = 100000;
+
+// Run `f` on every thread at once, returning the nanoseconds per copy.
+template <typename F>
+static
+double
+contend(
+    F f
+)
+{
+    std::atomic<size_t> ready(0);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < THREADS; ++i) {
+        threads.emplace_back([&] {
+            ready.fetch_add(1, std::memory_order_relaxed);
+            while (ready.load(std::memory_order_relaxed) != THREADS) {
+                std::this_thread::yield();
+            }
+            f();
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+    return static_cast<double>(ns) / (THREADS * COPIES);
+}
+
+// TESTS
+// -----
+
+static
+void
+test_contention()
+{
+    {
+        shared_ptr<counted> p = make_shared<counted>();
+        std::atomic<size_t> copies(0);
+
+        double shared_ns = contend([&] {
+            size_t n = 0;
+            for (size_t i = 0; i < COPIES; ++i) {
+                shared_ptr<counted> copy = p;
+                n += copy.get() != nullptr;
+            }
+            copies.fetch_add(n, std::memory_order_relaxed);
+        });
+        PYCPP_CHECK(p.use_count() == 1);
+
+        double local_ns = contend([&] {
+            local_ref<counted> local(p);
+            size_t n = 0;
+            for (size_t i = 0; i < COPIES; ++i) {
+                local_ref<counted> copy = local;
+                n += copy.local_count() == 2;
+            }
+            copies.fetch_add(n, std::memory_order_relaxed);
+        });
+        PYCPP_CHECK(p.use_count() == 1);
+        PYCPP_CHECK(copies == 2 * THREADS * COPIES);
+
+        std::printf("%zu threads: shared_ptr %.2f ns/copy, local_ref %.2f ns/copy\n", THREADS, shared_ns, local_ns);
+    }
+    PYCPP_CHECK(counted::alive == 0);
+}
+
+
+// References handed to other threads through `shared()` keep the
+// object alive after every local reference is gone.
+static
+void
+test_shared_handoff()
+{
+    std::vector<shared_ptr<counted>> handed(THREADS);
+    {
+        local_ref<counted> local(make_shared<counted>());
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < THREADS; ++i) {
+            threads.emplace_back([&handed, i](shared_ptr<counted> p) {
+                local_ref<counted> mine(std::move(p));
+                handed[i] = mine.shared();
+            }, local.shared());
+        }
+        for (auto& thread: threads) {
+            thread.join();
+        }
+    }
+
+    PYCPP_CHECK(counted::alive == 1);
+    PYCPP_CHECK(handed[0].use_count() == static_cast<long>(THREADS));
+    handed.clear();
+    PYCPP_CHECK(counted::alive == 0);
+}
+
+int
+main()
+{
+    test_contention();
+    test_shared_handoff();
+    return check_status();
+}
@@ -0,0 +1,149 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Growth of pmr containers through `do_reallocate`.
+ */
+
+#include <pycpp/stl/memory_resource.h>
+#include <pycpp/stl/vector.h>
+#include "../check.h"
+
+PYCPP_USING_NAMESPACE
+
+// OBJECTS
+// -------
+
+// Bump allocator over a fixed buffer, which extends its most recent
+// allocation in-place, and counts the reallocations requiring a copy.
+class arena_resource final: public pmr::memory_resource
+{
+public:
+    size_t copies = 0;
+    size_t inplace = 0;
+
+protected:
+    virtual
+    void*
+    do_allocate(
+        size_t n,
+        size_t alignment
+    )
+    override
+    {
+        size_t offset = (used_ + alignment - 1) & ~(alignment - 1);
+        if (offset + n > sizeof(buffer_)) {
+            throw std::bad_alloc();
+        }
+        last_ = offset;
+        used_ = offset + n;
+        return buffer_ + offset;
+    }
+
+    virtual
+    void*
+    do_reallocate(
+        void* p,
+        size_t old_size,
+        size_t new_size,
+        size_t n,
+        size_t old_offset,
+        size_t new_offset,
+        size_t alignment
+    )
+    override
+    {
+        char* c = static_cast<char*>(p);
+        if (c == buffer_ + last_ && last_ + new_size <= sizeof(buffer_) && old_offset == new_offset) {
+            used_ = last_ + new_size;
+            ++inplace;
+            return p;
+        }
+        ++copies;
+        return pmr::memory_resource::do_reallocate(p, old_size, new_size, n, old_offset, new_offset, alignment);
+    }
+
+    virtual
+    void
+    do_deallocate(
+        void* p,
+        size_t,
+        size_t
+    )
+    override
+    {
+        if (static_cast<char*>(p) == buffer_ + last_) {
+            used_ = last_;
+        }
+    }
+
+    virtual
+    bool
+    do_is_equal(
+        const pmr::memory_resource& x
+    )
+    const noexcept
+    override
+    {
+        return this == &x;
+    }
+
+private:
+    alignas(std::max_align_t) char buffer_[1 << 16];
+    size_t used_ = 0;
+    size_t last_ = 0;
+};
+
+// TESTS
+// -----
+
+static
+void
+test_vector_growth()
+{
+    arena_resource arena;
+    using allocator_type = pmr::polymorphic_allocator<int>;
+    vector<int, allocator_type> v{allocator_type(&arena)};
+
+    v.push_back(0);
+    const int* first = v.data();
+    for (int i = 1; i < 10000; ++i) {
+        v.push_back(i);
+        PYCPP_CHECK(v.data() == first);
+    }
+
+    bool values = true;
+    for (int i = 0; i < 10000; ++i) {
+        values = values && v[i] == i;
+    }
+    PYCPP_CHECK(values);
+    PYCPP_CHECK(arena.copies == 0);
+    PYCPP_CHECK(arena.inplace > 0);
+}
+
+
+static
+void
+test_vector_resize()
+{
+    arena_resource arena;
+    using allocator_type = pmr::polymorphic_allocator<double>;
+    vector<double, allocator_type> v{allocator_type(&arena)};
+
+    v.resize(1);
+    const double* first = v.data();
+    for (size_t n = 2; n < 4096; n *= 2) {
+        v.resize(n, 1.0);
+        PYCPP_CHECK(v.data() == first);
+    }
+    PYCPP_CHECK(arena.copies == 0);
+}
+
+
+int
+main()
+{
+    test_vector_growth();
+    test_vector_resize();
+    return check_status();
+}
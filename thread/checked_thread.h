@@ -8,7 +8,13 @@
  *  more than thread at a time. If the thread of execution changes,
  *  and the code is not thread-safe, abort program execution.
  *
+ *  Threads are identified by `checked_thread_id()`, which, unlike
+ *  `std::thread::id`, is never reused by a later thread, so it may
+ *  also record which thread owns an object.
+ *
  *  \synopsis
+ *      uintptr_t checked_thread_id() noexcept;
+ *
  *      template <bool ThreadSafe>
  *      struct checked_thread
  *      {
@@ -20,11 +26,28 @@
 #pragma once
 
 #include <pycpp/config.h>
+#include <atomic>
 #include <cassert>
-#include <thread>
+#include <cstdint>
 
 PYCPP_BEGIN_NAMESPACE
 
+// FUNCTIONS
+// ---------
+
+/**
+ *  \brief Identifier of the calling thread, which is never 0.
+ */
+inline
+uintptr_t
+checked_thread_id()
+noexcept
+{
+    static std::atomic<uintptr_t> counter(1);
+    static thread_local uintptr_t id = counter.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
 // OBJECTS
 // -------
 
@@ -73,7 +96,7 @@ struct checked_thread<false>
 {
     checked_thread()
     noexcept:
-        id(std::this_thread::get_id())
+        id(checked_thread_id())
     {}
 
     void
@@ -81,12 +104,12 @@ struct checked_thread<false>
     const noexcept
     {
         assert(
-            id == std::this_thread::get_id() &&
+            id == checked_thread_id() &&
             "Thread of execution does not match initial thread ID."
         );
     }
 
-    std::thread::id id;
+    uintptr_t id;
 };
 
 #endif                      // NDEBUG
@@ -9,7 +9,11 @@
 
 #include <pycpp/stl/type_traits/disable_if.h>
 #include <pycpp/stl/type_traits/endian.h>
+#include <pycpp/stl/type_traits/has_allocate_at_least.h>
+#include <pycpp/stl/type_traits/has_allocate_zeroed.h>
 #include <pycpp/stl/type_traits/has_reallocate.h>
+#include <pycpp/stl/type_traits/has_reallocate_at_least.h>
+#include <pycpp/stl/type_traits/has_unique_object_representations.h>
 #include <pycpp/stl/type_traits/is_aggregate.h>
 #include <pycpp/stl/type_traits/is_array.h>
 #include <pycpp/stl/type_traits/is_complete.h>
@@ -20,6 +24,8 @@
 #include <pycpp/stl/type_traits/is_safe_overload.h>
 #include <pycpp/stl/type_traits/is_swappable.h>
 #include <pycpp/stl/type_traits/is_trivial.h>
+#include <pycpp/stl/type_traits/is_trivially_hashable.h>
+#include <pycpp/stl/type_traits/is_zero_initializable.h>
 #include <pycpp/stl/type_traits/logical.h>
 #include <pycpp/stl/type_traits/remove_cvref.h>
 #include <pycpp/stl/type_traits/void_t.h>
@@ -0,0 +1,100 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Detect if allocator reports the size of allocations.
+ *
+ *  \synopsis
+ *      template <typename Allocator>
+ *      struct has_allocate_at_least;
+ *
+ *      template <typename T, typename R = void>
+ *      using enable_allocate_at_least = implementation-defined;
+ *
+ *      template <typename T, typename R = void>
+ *      using enable_allocate_at_least_t = implementation-defined;
+ *
+ *      #ifdef PYCPP_CPP14
+ *
+ *      template <typename T>
+ *      constexpr bool has_allocate_at_least_v = implementation-defined;
+ *
+ *      #endif
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+#include <pycpp/preprocessor/compiler.h>
+#include <memory>
+#include <type_traits>
+
+PYCPP_BEGIN_NAMESPACE
+
+// SFINAE
+// ------
+
+// TYPE
+
+// Check if the allocator has `allocate_at_least`, an extension.
+template <typename T>
+class has_allocate_at_least_impl
+{
+protected:
+    // Allocate at least has a function declaration as follows:
+    // allocation_result<pointer, size_type>
+    // allocate_at_least(
+    //      size_type n
+    // )
+    //
+    // Check on an lvalue, since `allocator_traits` calls it on one.
+    // The result is a class, so detect the expression via `void*`.
+
+    template <typename C>
+    static
+    char
+    &test(
+        decltype(void(
+            std::declval<C&>().allocate_at_least(
+                std::declval<typename std::allocator_traits<C>::size_type>()
+            )
+        ))*
+    );
+
+    template <typename C>
+    static
+    long
+    &test(...);
+
+public:
+    enum {
+        value = sizeof(test<T>(0)) == sizeof(char)
+    };
+};
+
+template <typename T>
+struct has_allocate_at_least: std::integral_constant<bool, has_allocate_at_least_impl<T>::value>
+{};
+
+// ENABLE IF
+
+template <typename T, typename R = void>
+using enable_allocate_at_least = std::enable_if<
+    has_allocate_at_least<T>::value,
+    R
+>;
+
+template <typename T, typename R = void>
+using enable_allocate_at_least_t = typename enable_allocate_at_least<T, R>::type;
+
+#ifdef PYCPP_CPP14
+
+// SFINAE
+// ------
+
+template <typename T>
+constexpr bool has_allocate_at_least_v = has_allocate_at_least<T>::value;
+
+#endif
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,99 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Detect if allocator supports allocating zero-initialized memory.
+ *
+ *  \synopsis
+ *      template <typename Allocator>
+ *      struct has_allocate_zeroed;
+ *
+ *      template <typename T, typename R = void>
+ *      using enable_allocate_zeroed = implementation-defined;
+ *
+ *      template <typename T, typename R = void>
+ *      using enable_allocate_zeroed_t = implementation-defined;
+ *
+ *      #ifdef PYCPP_CPP14
+ *
+ *      template <typename T>
+ *      constexpr bool has_allocate_zeroed_v = implementation-defined;
+ *
+ *      #endif
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+#include <pycpp/preprocessor/compiler.h>
+#include <memory>
+#include <type_traits>
+
+PYCPP_BEGIN_NAMESPACE
+
+// SFINAE
+// ------
+
+// TYPE
+
+// Check if the allocator has `allocate_zeroed`, an extension.
+template <typename T>
+class has_allocate_zeroed_impl
+{
+protected:
+    // Allocate zeroed has a function declaration as follows:
+    // pointer
+    // allocate_zeroed(
+    //      size_type n
+    // )
+    //
+    // Check on an lvalue, since `allocator_traits` calls it on one.
+
+    template <typename C>
+    static
+    char
+    &test(
+        decltype(
+            std::declval<C&>().allocate_zeroed(
+                std::declval<typename std::allocator_traits<C>::size_type>()
+            )
+        )
+    );
+
+    template <typename C>
+    static
+    long
+    &test(...);
+
+public:
+    enum {
+        value = sizeof(test<T>(0)) == sizeof(char)
+    };
+};
+
+template <typename T>
+struct has_allocate_zeroed: std::integral_constant<bool, has_allocate_zeroed_impl<T>::value>
+{};
+
+// ENABLE IF
+
+template <typename T, typename R = void>
+using enable_allocate_zeroed = std::enable_if<
+    has_allocate_zeroed<T>::value,
+    R
+>;
+
+template <typename T, typename R = void>
+using enable_allocate_zeroed_t = typename enable_allocate_zeroed<T, R>::type;
+
+#ifdef PYCPP_CPP14
+
+// SFINAE
+// ------
+
+template <typename T>
+constexpr bool has_allocate_zeroed_v = has_allocate_zeroed<T>::value;
+
+#endif
+
+PYCPP_END_NAMESPACE
@@ -51,13 +51,15 @@ protected:
     //      size_type old_offset = 0,
     //      size_type new_offset = 0
     // )
+    //
+    // Check on an lvalue, since `allocator_traits` calls it on one.
 
     template <typename C>
     static
     char
     &test(
         decltype(
-            std::declval<C>().reallocate(
+            std::declval<C&>().reallocate(
                 std::declval<typename std::allocator_traits<C>::pointer>(),
                 std::declval<typename std::allocator_traits<C>::size_type>(),
                 std::declval<typename std::allocator_traits<C>::size_type>(),
@@ -0,0 +1,110 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Detect if allocator reports the size of reallocations.
+ *
+ *  \synopsis
+ *      template <typename Allocator>
+ *      struct has_reallocate_at_least;
+ *
+ *      template <typename T, typename R = void>
+ *      using enable_reallocate_at_least = implementation-defined;
+ *
+ *      template <typename T, typename R = void>
+ *      using enable_reallocate_at_least_t = implementation-defined;
+ *
+ *      #ifdef PYCPP_CPP14
+ *
+ *      template <typename T>
+ *      constexpr bool has_reallocate_at_least_v = implementation-defined;
+ *
+ *      #endif
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+#include <pycpp/preprocessor/compiler.h>
+#include <memory>
+#include <type_traits>
+
+PYCPP_BEGIN_NAMESPACE
+
+// SFINAE
+// ------
+
+// TYPE
+
+// Check if the allocator has `reallocate_at_least`, an extension.
+template <typename T>
+class has_reallocate_at_least_impl
+{
+protected:
+    // Reallocate at least has a function declaration as follows:
+    // allocation_result<pointer, size_type>
+    // reallocate_at_least(
+    //      pointer ptr,
+    //      size_type old_size,
+    //      size_type new_size,
+    //      size_type count,
+    //      size_type old_offset = 0,
+    //      size_type new_offset = 0
+    // )
+    //
+    // Check on an lvalue, since `allocator_traits` calls it on one.
+    // The result is a class, so detect the expression via `void*`.
+
+    template <typename C>
+    static
+    char
+    &test(
+        decltype(void(
+            std::declval<C&>().reallocate_at_least(
+                std::declval<typename std::allocator_traits<C>::pointer>(),
+                std::declval<typename std::allocator_traits<C>::size_type>(),
+                std::declval<typename std::allocator_traits<C>::size_type>(),
+                std::declval<typename std::allocator_traits<C>::size_type>(),
+                std::declval<typename std::allocator_traits<C>::size_type>(),
+                std::declval<typename std::allocator_traits<C>::size_type>()
+            )
+        ))*
+    );
+
+    template <typename C>
+    static
+    long
+    &test(...);
+
+public:
+    enum {
+        value = sizeof(test<T>(0)) == sizeof(char)
+    };
+};
+
+template <typename T>
+struct has_reallocate_at_least: std::integral_constant<bool, has_reallocate_at_least_impl<T>::value>
+{};
+
+// ENABLE IF
+
+template <typename T, typename R = void>
+using enable_reallocate_at_least = std::enable_if<
+    has_reallocate_at_least<T>::value,
+    R
+>;
+
+template <typename T, typename R = void>
+using enable_reallocate_at_least_t = typename enable_reallocate_at_least<T, R>::type;
+
+#ifdef PYCPP_CPP14
+
+// SFINAE
+// ------
+
+template <typename T>
+constexpr bool has_reallocate_at_least_v = has_reallocate_at_least<T>::value;
+
+#endif
+
+PYCPP_END_NAMESPACE
@@ -0,0 +1,93 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief `has_unique_object_representations` backport for C++11.
+ *
+ *  Detects types where two objects with the same value have the same
+ *  bytes, such as integers and structs of integers without padding.
+ *  Uses the compiler intrinsic where available, otherwise falls back
+ *  to integral, enum and pointer types, and arrays of them.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      struct has_unique_object_representations: implementation-defined
+ *      {};
+ *
+ *      #ifdef PYCPP_CPP14
+ *
+ *      template <typename T>
+ *      constexpr bool has_unique_object_representations_v = implementation-defined;
+ *
+ *      #endif
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+#include <pycpp/preprocessor/compiler.h>
+#include <type_traits>
+
+PYCPP_BEGIN_NAMESPACE
+
+// ALIAS
+// -----
+
+#if defined(PYCPP_CPP17)            // CPP17
+
+using std::has_unique_object_representations;
+
+#else                               // <=CPP14
+
+// MACROS
+// ------
+
+#if defined(PYCPP_CLANG)                        // CLANG
+#   if PYCPP_IS_IDENTIFIER(__has_unique_object_representations) == 0
+#       define PYCPP_HAS_UNIQUE_OBJECT_REPRESENTATIONS(T) __has_unique_object_representations(T)
+#   endif
+#elif defined(PYCPP_GNUC)                       // GNUC
+#   if PYCPP_GNUC_MAJOR_VERSION >= 7
+#       define PYCPP_HAS_UNIQUE_OBJECT_REPRESENTATIONS(T) __has_unique_object_representations(T)
+#   endif
+#elif defined(PYCPP_MSVC)                       // MSVC
+#   if _MSC_VER >= 1911
+#       define PYCPP_HAS_UNIQUE_OBJECT_REPRESENTATIONS(T) __has_unique_object_representations(T)
+#   endif
+#endif                                          // CLANG
+
+// ALIAS
+// -----
+
+#if defined(PYCPP_HAS_UNIQUE_OBJECT_REPRESENTATIONS)     // INTRINSIC
+
+template <typename T>
+struct has_unique_object_representations: std::integral_constant<
+        bool,
+        PYCPP_HAS_UNIQUE_OBJECT_REPRESENTATIONS(typename std::remove_cv<typename std::remove_all_extents<T>::type>::type)
+    >
+{};
+
+#else                                                   // !INTRINSIC
+
+template <typename T>
+struct has_unique_object_representations: std::integral_constant<
+        bool,
+        std::is_integral<typename std::remove_all_extents<T>::type>::value ||
+        std::is_enum<typename std::remove_all_extents<T>::type>::value ||
+        std::is_pointer<typename std::remove_all_extents<T>::type>::value
+    >
+{};
+
+#endif                                                  // INTRINSIC
+
+#endif                              // CPP17
+
+#if defined(PYCPP_CPP14)
+
+template <typename T>
+constexpr bool has_unique_object_representations_v = has_unique_object_representations<T>::value;
+
+#endif                              // CPP14
+
+PYCPP_END_NAMESPACE
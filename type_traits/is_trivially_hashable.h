@@ -0,0 +1,70 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Detect if a type may be hashed by its bytes.
+ *
+ *  A type is trivially hashable if equal values always have equal
+ *  bytes, so hashing the object representation is consistent with
+ *  `operator==`. This defaults to `has_unique_object_representations`,
+ *  which excludes floating-point types, where `0.0 == -0.0`, and
+ *  classes with padding. Without compiler support, only integral, enum
+ *  and pointer types are detected, so specialize this for trivially
+ *  copyable structs without padding whose equality compares every
+ *  member.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      struct is_trivially_hashable;
+ *
+ *      template <typename T, typename R = void>
+ *      using enable_trivially_hashable = implementation-defined;
+ *
+ *      template <typename T, typename R = void>
+ *      using enable_trivially_hashable_t = implementation-defined;
+ *
+ *      #ifdef PYCPP_CPP14
+ *
+ *      template <typename T>
+ *      constexpr bool is_trivially_hashable_v = implementation-defined;
+ *
+ *      #endif
+ */
+
+#pragma once
+
+#include <pycpp/stl/type_traits/has_unique_object_representations.h>
+
+PYCPP_BEGIN_NAMESPACE
+
+// SFINAE
+// ------
+
+// TYPE
+
+template <typename T>
+struct is_trivially_hashable: has_unique_object_representations<T>
+{};
+
+// ENABLE IF
+
+template <typename T, typename R = void>
+using enable_trivially_hashable = std::enable_if<
+    is_trivially_hashable<T>::value,
+    R
+>;
+
+template <typename T, typename R = void>
+using enable_trivially_hashable_t = typename enable_trivially_hashable<T, R>::type;
+
+#ifdef PYCPP_CPP14
+
+// SFINAE
+// ------
+
+template <typename T>
+constexpr bool is_trivially_hashable_v = is_trivially_hashable<T>::value;
+
+#endif
+
+PYCPP_END_NAMESPACE
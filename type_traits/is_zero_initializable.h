@@ -0,0 +1,73 @@
+//  :copyright: (c) 2017-2018 Alex Huszagh.
+//  :license: MIT, see licenses/mit.md for more details.
+/**
+ *  \addtogroup PySTD
+ *  \brief Detect if a value-initialized type is represented by zero bytes.
+ *
+ *  Value-initialized scalars, and arrays of scalars, are all-zero bytes
+ *  on every supported platform, with the exception of pointers to
+ *  data members, which use `-1` for null in the Itanium ABI. Such types
+ *  may be constructed in bulk via `memset`, or use memory already zeroed
+ *  by `calloc`. Specialize this for trivial class types whose
+ *  value-initialized representation is all zero bytes.
+ *
+ *  \synopsis
+ *      template <typename T>
+ *      struct is_zero_initializable;
+ *
+ *      template <typename T, typename R = void>
+ *      using enable_zero_initializable = implementation-defined;
+ *
+ *      template <typename T, typename R = void>
+ *      using enable_zero_initializable_t = implementation-defined;
+ *
+ *      #ifdef PYCPP_CPP14
+ *
+ *      template <typename T>
+ *      constexpr bool is_zero_initializable_v = implementation-defined;
+ *
+ *      #endif
+ */
+
+#pragma once
+
+#include <pycpp/config.h>
+#include <type_traits>
+
+PYCPP_BEGIN_NAMESPACE
+
+// SFINAE
+// ------
+
+// TYPE
+
+template <typename T>
+struct is_zero_initializable: std::integral_constant<
+        bool,
+        std::is_scalar<typename std::remove_all_extents<T>::type>::value &&
+        !std::is_member_pointer<typename std::remove_all_extents<T>::type>::value
+    >
+{};
+
+// ENABLE IF
+
+template <typename T, typename R = void>
+using enable_zero_initializable = std::enable_if<
+    is_zero_initializable<T>::value,
+    R
+>;
+
+template <typename T, typename R = void>
+using enable_zero_initializable_t = typename enable_zero_initializable<T, R>::type;
+
+#ifdef PYCPP_CPP14
+
+// SFINAE
+// ------
+
+template <typename T>
+constexpr bool is_zero_initializable_v = is_zero_initializable<T>::value;
+
+#endif
+
+PYCPP_END_NAMESPACE